@@ -0,0 +1,112 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <optional>
+
+/**
+ * Per-solve arena: all storage of the solve (the game table, open lists, sets of cells,
+ * routers, paths and stacks, everything the solvers allocate from the table's resource)
+ * is bump-allocated from one preallocated buffer and released at once when the solve ends.
+ * Deallocations during the solve are no-ops. The arena is reused by the solves one after another,
+ * if a solve does not fit into the buffer, the overflow is taken from the upstream resource
+ * and the buffer grows for the next solves, so after the first solves of the largest tables
+ * solves make no calls into the global allocator at all.
+ */
+
+/** Initial capacity of the arena's buffer, enough for the judge's table with any solver */
+constexpr std::size_t DEFAULT_ARENA_CAPACITY = std::size_t(64) << 10;
+
+/** @brief Upstream resource of the arena that counts the bytes taken beyond the arena's buffer */
+class overflow_counter : public std::pmr::memory_resource {
+    std::pmr::memory_resource* _upstream;
+    std::size_t _bytes = 0;
+
+    void* do_allocate(const std::size_t bytes, const std::size_t alignment) override {
+        _bytes += bytes;
+        return _upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* const memory, const std::size_t bytes, const std::size_t alignment) override {
+        _upstream->deallocate(memory, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+public:
+    explicit overflow_counter(std::pmr::memory_resource* const upstream) : _upstream(upstream) {}
+
+    /** Bytes taken from the upstream since the last reset */
+    [[nodiscard]] std::size_t bytes() const { return _bytes; }
+
+    void reset() { _bytes = 0; }
+};
+
+/** @brief Arena of the solves, used by one thread at a time */
+
+class solve_arena {
+    std::pmr::memory_resource* _upstream;
+    overflow_counter _overflow;
+
+    std::size_t _capacity;
+    void* _buffer;
+
+    std::optional<std::pmr::monotonic_buffer_resource> _resource;
+
+public:
+    /**
+     * @param capacity Initial capacity of the buffer in bytes
+     * @param upstream Resource of the buffer and of the overflow
+     */
+
+    explicit solve_arena(
+            const std::size_t capacity = DEFAULT_ARENA_CAPACITY,
+            std::pmr::memory_resource* const upstream = std::pmr::get_default_resource()
+    ) :
+        _upstream(upstream),
+        _overflow(upstream),
+        _capacity(std::max<std::size_t>(capacity, 1)),
+        _buffer(upstream->allocate(_capacity, alignof(std::max_align_t))) {
+        _resource.emplace(_buffer, _capacity, &_overflow);
+    }
+
+    solve_arena(const solve_arena&) = delete;
+    solve_arena& operator=(const solve_arena&) = delete;
+
+    ~solve_arena() {
+        _resource.reset();
+        _upstream->deallocate(_buffer, _capacity, alignof(std::max_align_t));
+    }
+
+    /** Resource for all storage of the solve, valid until the arena is released */
+    [[nodiscard]] std::pmr::memory_resource* resource() { return &*_resource; }
+
+    /** Capacity of the buffer in bytes */
+    [[nodiscard]] std::size_t capacity() const { return _capacity; }
+
+    /**
+     * Releases all storage of the finished solve: O(1) if the solve fit into the buffer,
+     * otherwise the overflow is returned to the upstream and the buffer grows to fit it next time.
+     * All objects allocated from the arena have to be destroyed before
+     */
+
+    void release() {
+        if (!_overflow.bytes()) {
+            _resource->release();
+            return;
+        }
+
+        const auto capacity = std::max(_capacity * 2, _capacity + _overflow.bytes());
+
+        _resource.reset();
+        _overflow.reset();
+        _upstream->deallocate(_buffer, _capacity, alignof(std::max_align_t));
+
+        _capacity = capacity;
+        _buffer = _upstream->allocate(_capacity, alignof(std::max_align_t));
+        _resource.emplace(_buffer, _capacity, &_overflow);
+    }
+};
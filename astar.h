@@ -0,0 +1,1221 @@
+#pragma once
+
+#include <iostream>
+#include <tuple>
+#include <utility>
+#include <ranges>
+#include <vector>
+#include <cstdint>
+#include <set>
+#include <memory_resource>
+#include <algorithm>
+#include <bit>
+#include <string>
+#include <string_view>
+
+#include "grid.h"
+#include "bitboard.h"
+#include "router.h"
+#include "transport.h"
+#include "instrumentation.h"
+
+/**
+ * Solver planning the path with A* (or LPA* in the incremental mode) over the perceived table, the main of the player is in astar.cpp
+ */
+
+namespace astar {
+
+/**
+ * @brief Represents a cell on the simulation table.
+ * Plain record without any owning members, so the whole table is a single contiguous array.
+ * Coordinates are not stored, they are derived from the cell's index in the table.
+ */
+
+struct cell {
+    /** The cost to move to this cell from the player's initial position */
+    int from_player_cost = INF;
+
+    /** Manhattan distance to the Infinity Stone */
+    int to_target_cost = INF;
+
+    /** Index of the parent cell to reconstruct the path */
+    cell_index parent = NO_CELL;
+
+    /** Event of the cell (perception, picked by hero, etc.) */
+    char cell_status = 0;
+
+    /** Heuristics function to use for the priority queue in A* algorithm */
+    [[nodiscard]] int sum_cost() const { return from_player_cost + to_target_cost; }
+
+    /**
+     * Checks whether the cell is dangerous to move
+     * @return true if the cell is dangerous, false otherwise.
+     */
+
+    [[nodiscard]] bool dangerous_status() const { return ::dangerous_status(cell_status); }
+};
+
+/** Reversed path of cells, from the last cell to the initial one */
+using cell_path = std::pmr::vector<cell_index>;
+
+/** Simulation table of the A* algorithm with the given dimensions */
+template <typename extent> using game_table = grid<cell, extent>;
+
+/**
+ * Constructs path for the given cell.
+ * Path includes all cells from initial player position (0, 0) to the given one.
+ * Note that the path is optimal only for the current state of the game.
+ * Result is the local best, however, it may be better after other steps of
+ * algorithm are launched and analysed.
+ * Path is written to the caller's buffer, so no allocation happens
+ * once the buffer has reserved capacity for the whole table.
+ *
+ * @param table The game table
+ * @param c Cell for which path should be built
+ * @param path Buffer for the constructed reversed path
+ * (e.g. [cell, cell.parent, cell.parent.parent, ... initial cell])
+ */
+
+template <typename extent> void construct_path(
+        const game_table<extent>& table,
+        const cell_index c,
+        cell_path& path
+) {
+    path.clear();
+
+    for (auto cl = c; cl != NO_CELL; cl = table[cl].parent)
+        path.push_back(cl);
+}
+
+/**
+ * @brief Key of the cell in the priority queue of A* algorithm:
+ * the lowest total cost first, ties are resolved with Manhattan distance,
+ * the cost from the player and, at last, coordinates of cells
+ * (row-major index keeps ordering by the row, then by the column)
+ */
+
+struct open_key {
+    int sum_cost;
+    int to_target_cost;
+    int from_player_cost;
+    cell_index c;
+
+    auto operator<=>(const open_key&) const = default;
+};
+
+/**
+ * Constructs the priority queue key of the cell from its current costs
+ * @param cells Cells of the game table
+ * @param c Cell to construct key for
+ */
+
+[[nodiscard]] open_key key_of(const std::span<const cell> cells, const cell_index c) {
+    const auto& cl = cells[c];
+    return { cl.sum_cost(), cl.to_target_cost, cl.from_player_cost, c };
+}
+
+/** @brief Order of cells in the priority queue of A* algorithm (see open_key) */
+
+struct cell_order {
+    /** Cells of the game table to compare */
+    std::span<const cell> cells;
+
+    bool operator()(const cell_index first, const cell_index second) const {
+        return key_of(cells, first) < key_of(cells, second);
+    }
+};
+
+/**
+ * @brief Open list of A* algorithm on top of the std::set.
+ * Every insertion allocates a tree node, decrease-key is erase + insert.
+ *
+ * All open lists share the same interface:
+ * they are constructed from the cells of the game table and the memory resource of the solve,
+ * push() inserts the cell with its current costs, decrease_key() is called
+ * after the costs of the already queued cell were lowered,
+ * pop() removes and returns the cell with the lowest key,
+ * size() is the number of queued cells.
+ */
+
+class set_queue {
+    /** Queued cells ordered by their keys */
+    std::pmr::set<open_key> _queue;
+
+    /** Keys of the queued cells, required to find them after their costs were changed */
+    std::pmr::vector<open_key> _keys;
+
+    /** Cells of the game table with their costs */
+    std::span<const cell> _cells;
+
+public:
+    explicit set_queue(
+            const std::span<const cell> cells,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    ) :
+        _queue(resource),
+        _keys(cells.size(), open_key { 0, 0, 0, NO_CELL }, resource),
+        _cells(cells) {}
+
+    [[nodiscard]] bool empty() const { return _queue.empty(); }
+
+    [[nodiscard]] std::size_t size() const { return _queue.size(); }
+
+    [[nodiscard]] bool contains(const cell_index c) const { return _keys[c].c != NO_CELL; }
+
+    void push(const cell_index c) {
+        _keys[c] = key_of(_cells, c);
+        _queue.insert(_keys[c]);
+    }
+
+    void decrease_key(const cell_index c) {
+        _queue.erase(_keys[c]);
+        push(c);
+    }
+
+    [[nodiscard]] cell_index pop() {
+        const auto c = _queue.begin()->c;
+        _queue.erase(_queue.begin());
+        _keys[c].c = NO_CELL;
+        return c;
+    }
+};
+
+/**
+ * @brief Monotone bucket queue for the open list of A* algorithm.
+ * Total cost of a cell is a small bounded integer, so cells are distributed into buckets
+ * indexed by the total cost. With the consistent Manhattan heuristics, A* never pushes
+ * cells with the total cost below the last popped one, so the cursor to the lowest
+ * non-empty bucket only moves forward.
+ *
+ * Within the bucket cells are kept in a binary heap by the rest of the key
+ * (Manhattan distance, then coordinates; the cost from player is fixed by both).
+ * Positions of cells in heaps are tracked, so decrease-key moves the cell to the lower bucket
+ * without any lookups. Buckets keep their capacity, so no allocations happen
+ * once the queue has warmed up.
+ */
+
+class bucket_queue {
+    /** Marks the cell that is not in the queue */
+    static constexpr int NOT_QUEUED = -1;
+
+    /** Binary heaps of cells, indexed by the total cost (heaps share the memory resource of the queue) */
+    std::pmr::vector<std::pmr::vector<cell_index>> _buckets;
+
+    /** Bucket of every queued cell (total cost at the moment of push) or NOT_QUEUED */
+    std::pmr::vector<int> _bucket_of;
+
+    /** Position of every queued cell in its bucket's heap */
+    std::pmr::vector<std::uint32_t> _position;
+
+    /** The lowest bucket that may be non-empty */
+    std::size_t _cursor = 0;
+
+    /** Number of queued cells */
+    std::size_t _size = 0;
+
+    /** Cells of the game table with their costs */
+    std::span<const cell> _cells;
+
+    /** Order of cells within the same bucket */
+    [[nodiscard]] bool less(const cell_index first, const cell_index second) const {
+        const int first_cost = _cells[first].to_target_cost;
+        const int second_cost = _cells[second].to_target_cost;
+        return first_cost != second_cost ? first_cost < second_cost : first < second;
+    }
+
+    void place(std::pmr::vector<cell_index>& heap, const std::size_t pos, const cell_index c) {
+        heap[pos] = c;
+        _position[c] = pos;
+    }
+
+    void sift_up(std::pmr::vector<cell_index>& heap, std::size_t pos) {
+        const auto c = heap[pos];
+
+        for (; pos > 0; ) {
+            const auto parent = (pos - 1) / 2;
+            if (!less(c, heap[parent])) break;
+            place(heap, pos, heap[parent]);
+            pos = parent;
+        }
+
+        place(heap, pos, c);
+    }
+
+    void sift_down(std::pmr::vector<cell_index>& heap, std::size_t pos) {
+        const auto c = heap[pos];
+
+        for (;;) {
+            auto child = pos * 2 + 1;
+            if (child >= heap.size()) break;
+
+            if (child + 1 < heap.size() && less(heap[child + 1], heap[child]))
+                ++child;
+
+            if (!less(heap[child], c)) break;
+            place(heap, pos, heap[child]);
+            pos = child;
+        }
+
+        place(heap, pos, c);
+    }
+
+    /** Removes the queued cell from its bucket */
+    void remove(const cell_index c) {
+        auto& heap = _buckets[_bucket_of[c]];
+        const auto pos = _position[c];
+        const auto last = heap.back();
+        heap.pop_back();
+
+        if (last != c) {
+            place(heap, pos, last);
+            sift_down(heap, pos);
+            sift_up(heap, _position[last]);
+        }
+
+        _bucket_of[c] = NOT_QUEUED;
+        --_size;
+    }
+
+public:
+    explicit bucket_queue(
+            const std::span<const cell> cells,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    ) :
+        _buckets(resource),
+        _bucket_of(cells.size(), NOT_QUEUED, resource),
+        _position(cells.size(), resource),
+        _cells(cells) {}
+
+    [[nodiscard]] bool empty() const { return _size == 0; }
+
+    [[nodiscard]] std::size_t size() const { return _size; }
+
+    [[nodiscard]] bool contains(const cell_index c) const { return _bucket_of[c] != NOT_QUEUED; }
+
+    void push(const cell_index c) {
+        const auto bucket = static_cast<std::size_t>(_cells[c].sum_cost());
+
+        if (bucket >= _buckets.size())
+            _buckets.resize(bucket + 1);
+
+        // Non-monotone pushes are not expected with the consistent heuristics,
+        // but still have to be served correctly
+        _cursor = std::min(_cursor, bucket);
+
+        auto& heap = _buckets[bucket];
+        heap.push_back(c);
+        _bucket_of[c] = static_cast<int>(bucket);
+        sift_up(heap, heap.size() - 1);
+        ++_size;
+    }
+
+    void decrease_key(const cell_index c) {
+        remove(c);
+        push(c);
+    }
+
+    [[nodiscard]] cell_index pop() {
+        while (_buckets[_cursor].empty())
+            ++_cursor;
+
+        const auto c = _buckets[_cursor].front();
+        remove(c);
+        return c;
+    }
+};
+
+/**
+ * @brief Indexed d-ary heap of cells with decrease-key.
+ * Positions of cells in the heap are tracked, so decrease-key is a single sift-up
+ * and no nodes are allocated: storage is reserved for the whole table at construction.
+ * Unlike bucket_queue, the heap does not require keys to be small bounded integers,
+ * so it serves any cell order (e.g. weighted costs).
+ *
+ * @tparam compare Strict weak order of cells
+ * @tparam arity Number of children of every heap node
+ */
+
+template <typename compare, std::size_t arity = 4> class indexed_dary_heap {
+    static_assert(arity >= 2, "Heap node must have at least two children");
+
+    /** Marks the cell that is not in the heap */
+    static constexpr std::uint32_t NOT_QUEUED = UINT32_MAX;
+
+    /** Heap of cells */
+    std::pmr::vector<cell_index> _heap;
+
+    /** Position of every cell in the heap or NOT_QUEUED */
+    std::pmr::vector<std::uint32_t> _position;
+
+    /** Order of cells */
+    compare _less;
+
+    void place(const std::size_t pos, const cell_index c) {
+        _heap[pos] = c;
+        _position[c] = pos;
+    }
+
+    void sift_up(std::size_t pos) {
+        const auto c = _heap[pos];
+
+        for (; pos > 0; ) {
+            const auto parent = (pos - 1) / arity;
+            if (!_less(c, _heap[parent])) break;
+            place(pos, _heap[parent]);
+            pos = parent;
+        }
+
+        place(pos, c);
+    }
+
+    void sift_down(std::size_t pos) {
+        const auto c = _heap[pos];
+
+        for (;;) {
+            const auto first_child = pos * arity + 1;
+            if (first_child >= _heap.size()) break;
+
+            // Searching for the least child
+            const auto last_child = std::min(first_child + arity, _heap.size());
+            auto child = first_child;
+
+            for (auto next = first_child + 1; next < last_child; ++next)
+                if (_less(_heap[next], _heap[child]))
+                    child = next;
+
+            if (!_less(_heap[child], c)) break;
+            place(pos, _heap[child]);
+            pos = child;
+        }
+
+        place(pos, c);
+    }
+
+public:
+    /**
+     * Constructs an empty heap
+     * @param capacity Number of cells that may be stored in the heap
+     * @param less Order of cells
+     * @param resource Memory resource for the heap and the positions
+     */
+
+    indexed_dary_heap(
+            const std::size_t capacity,
+            compare less,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    ) :
+        _heap(resource),
+        _position(capacity, NOT_QUEUED, resource),
+        _less(std::move(less)) {
+        _heap.reserve(capacity);
+    }
+
+    [[nodiscard]] bool empty() const { return _heap.empty(); }
+
+    [[nodiscard]] std::size_t size() const { return _heap.size(); }
+
+    [[nodiscard]] bool contains(const cell_index c) const { return _position[c] != NOT_QUEUED; }
+
+    void push(const cell_index c) {
+        _heap.push_back(c);
+        sift_up(_heap.size() - 1);
+    }
+
+    void decrease_key(const cell_index c) { sift_up(_position[c]); }
+
+    /** Cell with the lowest key, heap must not be empty */
+    [[nodiscard]] cell_index top() const { return _heap.front(); }
+
+    /** Removes the queued cell, wherever it is in the heap */
+    void remove(const cell_index c) {
+        const auto pos = _position[c];
+        const auto last = _heap.back();
+        _heap.pop_back();
+        _position[c] = NOT_QUEUED;
+
+        if (last != c) {
+            place(pos, last);
+            sift_down(pos);
+            sift_up(_position[last]);
+        }
+    }
+
+    [[nodiscard]] cell_index pop() {
+        const auto c = _heap.front();
+        const auto last = _heap.back();
+        _heap.pop_back();
+        _position[c] = NOT_QUEUED;
+
+        if (!_heap.empty()) {
+            place(0, last);
+            sift_down(0);
+        }
+
+        return c;
+    }
+};
+
+/** @brief Open list of A* algorithm on top of the indexed d-ary heap */
+
+template <std::size_t arity = 4> class dary_heap_queue : public indexed_dary_heap<cell_order, arity> {
+public:
+    explicit dary_heap_queue(
+            const std::span<const cell> cells,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    ) :
+        indexed_dary_heap<cell_order, arity>(cells.size(), cell_order { cells }, resource) {}
+};
+
+using cell_priority_queue = bucket_queue;
+
+/** Set of cells: bitboard for the fixed-size tables, row-wise bitboard for the runtime-sized ones */
+template <typename extent> using restricted_cells = cell_set<extent>;
+
+/**
+ * @brief Initializes the game table with the specified coordinates for the Infinity Stone
+ * @param dimensions Dimensions of the game table
+ * @param inf_stone_n The row coordinate of the Infinity Stone
+ * @param inf_stone_m The column coordinate of the Infinity Stone
+ * @param resource Memory resource for the table and the rest of the solve's storage
+ * @return The initialized game table.
+ */
+
+template <typename extent> [[nodiscard]] game_table<extent> init_game_table(
+        const extent& dimensions,
+        const int inf_stone_n,
+        const int inf_stone_m,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+) {
+    // Creating game table, all statistical parameters are set to INF
+    game_table<extent> table(dimensions, resource);
+
+    // Initializing the initial player coordinate (0, 0)
+    auto& start = table[table.index(0, 0)];
+    start.from_player_cost = 0;
+    start.to_target_cost = manhattan_distance(0, 0, inf_stone_n, inf_stone_m);
+    start.cell_status = 'A';
+
+    // Initializing the Infinity Stone coordinate
+    auto& stone = table[table.index(inf_stone_n, inf_stone_m)];
+    stone.to_target_cost = 0;
+    stone.cell_status = 'I';
+
+    return table;
+}
+
+/**
+ * @brief Makes a move to the specified cell without the response analysis.
+ * Move may be batched by the transport, its response is discarded
+ * @param io Transport of the interactive protocol
+ * @param table The game table
+ * @param cur_pos Current player's position
+ * @param c The cell to move to
+ */
+
+template <typename extent, typename transport> void stupid_move(
+        transport& io,
+        const game_table<extent>& table,
+        cell_index& cur_pos,
+        const cell_index c
+) {
+    io.blind_move(table.m(c), table.n(c));
+    instrumentation::count_blind_move();
+    cur_pos = c;
+}
+
+/**
+ * Searches for the least common ancestor of both cells in the tree of parents.
+ * Every move costs 1, so the depth of the cell in the tree is its cost from the player.
+ * The deeper cell is lifted to the depth of the other one,
+ * then both cells are lifted together until they meet: O(depth) without allocations.
+ *
+ * @param table The game table
+ * @param first First cell
+ * @param second Second cell
+ * @return LCA cell if it is found, NO_CELL otherwise
+ */
+
+template <typename extent> [[nodiscard]] cell_index least_common_ancestor(
+        const game_table<extent>& table,
+        cell_index first,
+        cell_index second
+) {
+    auto depth = [&](const cell_index c) { return table[c].from_player_cost; };
+
+    while (first != NO_CELL && second != NO_CELL && depth(first) > depth(second))
+        first = table[first].parent;
+
+    while (first != NO_CELL && second != NO_CELL && depth(second) > depth(first))
+        second = table[second].parent;
+
+    while (first != second && first != NO_CELL && second != NO_CELL) {
+        first = table[first].parent;
+        second = table[second].parent;
+    }
+
+    return first == second ? first : NO_CELL;
+}
+
+/**
+ * @brief Binary lifting table over the tree of parents: 2^k-th ancestor of every cell.
+ * For large maps, where paths are thousands of cells long, LCA takes O(log depth).
+ * Row of the cell is filled once the cell is closed: its parent is closed before,
+ * so all its ancestors are final. Storage for the whole table is allocated
+ * at construction, so no allocations happen during the game.
+ */
+
+template <typename extent> class ancestor_table {
+    /** Number of cells in the table */
+    std::size_t _cells;
+
+    /** Number of levels, enough to lift through the longest possible path */
+    std::size_t _levels;
+
+    /** 2^k-th ancestors of all cells, level-major, NO_CELL above the initial cell */
+    std::pmr::vector<cell_index> _ancestors;
+
+    [[nodiscard]] cell_index& ancestor(const std::size_t level, const cell_index c) {
+        return _ancestors[level * _cells + c];
+    }
+
+    [[nodiscard]] cell_index ancestor(const std::size_t level, const cell_index c) const {
+        return _ancestors[level * _cells + c];
+    }
+
+public:
+    explicit ancestor_table(const game_table<extent>& table) :
+        _cells(table.size()),
+        _levels(std::bit_width(table.size())),
+        _ancestors(_levels * _cells, NO_CELL, table.resource()) {}
+
+    /**
+     * Fills ancestors of the closed cell
+     * @param table The game table
+     * @param c The closed cell, ancestors of its parent have to be filled before
+     */
+
+    void close(const game_table<extent>& table, const cell_index c) {
+        ancestor(0, c) = table[c].parent;
+
+        for (std::size_t level = 1; level < _levels; ++level) {
+            const auto half = ancestor(level - 1, c);
+            ancestor(level, c) = half == NO_CELL ? NO_CELL : ancestor(level - 1, half);
+        }
+    }
+
+    /**
+     * Searches for the least common ancestor of both closed cells
+     * @param table The game table
+     * @param first First cell
+     * @param second Second cell
+     * @return LCA cell if it is found, NO_CELL otherwise
+     */
+
+    [[nodiscard]] cell_index least_common_ancestor(
+            const game_table<extent>& table,
+            cell_index first,
+            cell_index second
+    ) const {
+        if (first == NO_CELL || second == NO_CELL)
+            return NO_CELL;
+
+        if (table[first].from_player_cost < table[second].from_player_cost)
+            std::swap(first, second);
+
+        // Lifting the deeper cell to the depth of the other one
+        const auto lift = static_cast<std::size_t>(table[first].from_player_cost - table[second].from_player_cost);
+
+        for (std::size_t level = 0; level < _levels; ++level)
+            if (lift >> level & 1)
+                first = ancestor(level, first);
+
+        if (first == second)
+            return first;
+
+        // Lifting both cells while their ancestors are different
+        for (auto level = _levels; level-- > 0; ) {
+            if (ancestor(level, first) != ancestor(level, second)) {
+                first = ancestor(level, first);
+                second = ancestor(level, second);
+            }
+        }
+
+        return ancestor(0, first);
+    }
+};
+
+/**
+ * Performs simple moves without the response analysis,
+ * until it reaches the target position.
+ * If route contains cell with the shield, we pick it.
+ * Route is the shortest one through the cells that are known to be safe,
+ * so the target has to be reachable with previously gained knowledge.
+ *
+ * @param io Transport of the interactive protocol
+ * @param table The game table
+ * @param router Router over the known safe cells
+ * @param cur_pos current position, that will be mutated,
+ * until the target position is reached
+ * @param target position to move to
+ * @param has_shield Indicates whether the player has a shield
+ * @param route Buffer for the route to the target
+ */
+
+template <typename extent, typename transport> void stupid_move_to_known_target(
+        transport& io,
+        const game_table<extent>& table,
+        travel_router<extent>& router,
+        cell_index& cur_pos,
+        const cell_index target,
+        bool& has_shield,
+        cell_path& route
+) {
+    router.route(cur_pos, target, route);
+
+    for (const auto c : route) {
+        stupid_move(io, table, cur_pos, c);
+
+        if (table[c].cell_status == 'S')
+            has_shield = true;
+    }
+}
+
+/**
+ * Adds the cell and its neighbours that are known to be safe to the router.
+ * The Infinity Stone is never added, so routes do not finish the game by accident
+ *
+ * @param table The game table
+ * @param router Router over the known safe cells
+ * @param c The visited cell, all its neighbours are perceived
+ */
+
+template <typename extent> void add_known_safe(
+        const game_table<extent>& table,
+        travel_router<extent>& router,
+        const cell_index c
+) {
+    auto add = [&](const cell_index safe) {
+        if (!table[safe].dangerous_status() && table[safe].cell_status != 'I')
+            router.add(safe);
+    };
+
+    add(c);
+
+    for (const auto neighbour : table.neighbours(c))
+        add(neighbour);
+}
+
+/**
+ * @brief Opens neighbouring cells and updates their states
+ * @param cur_pos Current player position
+ * @param inf_stone_n The row coordinate of the Infinity Stone
+ * @param inf_stone_m The column coordinate of the Infinity Stone
+ * @param table The game table (updated after the algorithm)
+ * @param open Priority queue for the A* algorithm (updated after the algorithm),
+ * any open list with the interface of set_queue
+ */
+
+template <typename extent, typename open_list> void open_neighbours(
+        const cell_index cur_pos,
+        const int inf_stone_n,
+        const int inf_stone_m,
+        game_table<extent>& table,
+        open_list& open
+) {
+    instrumentation::count_expansion();
+    const int new_from_player_cost = table[cur_pos].from_player_cost + 1;
+    const auto inf_stone = table.index(inf_stone_n, inf_stone_m);
+
+    // Trying to update all possible neighboring cells.
+    // Updating all valid cells that can be moved,
+    // even visited ones to reuse in the future, after the shield is picked
+
+    for (const auto c : table.neighbours(cur_pos)) {
+        auto& neighbour = table[c];
+
+        // If we found a better path, we can update both table and open PQ
+        if (!neighbour.dangerous_status() && new_from_player_cost < neighbour.from_player_cost) {
+            neighbour.from_player_cost = new_from_player_cost;
+            neighbour.to_target_cost = table.distance(c, inf_stone);
+            neighbour.parent = cur_pos;
+
+            if (open.contains(c))
+                open.decrease_key(c);
+            else
+                open.push(c);
+        }
+    }
+
+    instrumentation::observe_open_size(open.size());
+}
+
+/**
+ * @brief Moves to the specified cell and updates the game state accordingly
+ * @param io Transport of the interactive protocol
+ * @oaram cur_pos Current player position
+ * @param new_pos The cell to move to
+ * @param inf_stone_n The row coordinate of the Infinity Stone
+ * @param inf_stone_m The column coordinate of the Infinity Stone
+ * @param has_shield Indicates whether the player has a shield
+ * @param table The game table
+ * @param open A priority queue of cells to explore, sorted by their estimated total cost
+ * @param closed A set of cells that should not be reached in the current iteration
+ * @return True if the player has reached the Infinity Stone, false otherwise
+ */
+
+template <typename extent, typename open_list, typename transport> bool move_then_update(
+        transport& io,
+        cell_index& cur_pos,
+        const cell_index new_pos,
+        const int inf_stone_n,
+        const int inf_stone_m,
+        bool& has_shield,
+        game_table<extent>& table,
+        open_list& open,
+        restricted_cells<extent>& closed
+) {
+    // Sends request to move
+    io.move(table.m(new_pos), table.n(new_pos));
+
+    // We are done and not interested in the response
+    if (table[new_pos].cell_status == 'I')
+        return true;
+
+    cur_pos = new_pos;
+    closed.set(cur_pos);
+
+    // Picking shield if any
+    if (table[cur_pos].cell_status == 'S')
+        has_shield = true;
+
+    // Handles response and updates the game state with events from the response
+
+    for (const auto& [m, n, status] : io.response()) {
+        const auto c = table.index(n, m);
+        auto& perceived = table[c];
+        perceived.cell_status = status;
+
+        if (perceived.dangerous_status())
+            closed.set(c);
+    }
+
+    instrumentation::observe_closed_set(closed);
+    open_neighbours(cur_pos, inf_stone_n, inf_stone_m, table, open);
+    return false;
+}
+
+/**
+ * @brief Attempts to find a path to the Infinity Stone using an A* search algorithm
+ * @param io Transport of the interactive protocol
+ * @param inf_stone_n The row coordinate of the Infinity Stone
+ * @param inf_stone_m The column coordinate of the Infinity Stone
+ * @param has_shield Indicates whether the player picked the shield
+ * @param table The game table
+ * @param open A priority queue of cells to explore, sorted by their estimated total cost
+ * @param closed A set of cells that have been explored and their paths have been evaluated.
+ * @return True if a path to the Infinity Stone is found, false otherwise.
+ * @tparam open_list Open list of the algorithm with the interface of set_queue
+ * (set_queue, bucket_queue, dary_heap_queue)
+ */
+
+template <typename extent, typename open_list, typename transport> bool launch_a_star(
+        transport& io,
+        const int inf_stone_n,
+        const int inf_stone_m,
+        bool& has_shield,
+        game_table<extent>& table,
+        open_list& open,
+        restricted_cells<extent>& closed
+) {
+    // Initializing the current position to the initial cell
+    auto cur_pos = table.index(0, 0);
+
+    // Router over the visited cells and their perceived neighbours
+    travel_router<extent> router(table);
+
+    // Buffer for the travel routes, reserved once for the longest possible route
+    cell_path route(table.resource());
+    route.reserve(table.size());
+
+    // Continue the search as long as the open queue is not empty
+
+    while (!open.empty()) {
+        // The game is cancelled, e.g. the rival solver of the portfolio race has won
+        if (stop_requested(io))
+            return false;
+
+        // Find the cell with the lowest estimated total cost from the open queue
+        cell_index best;
+
+        // Iterate over the open queue until a cell is found that is not in the closed set
+
+        for (;;) {
+            best = open.pop();
+
+            // Skip cells that have already been explored and their paths have been evaluated.
+            if (!closed.test(best))
+                break;
+        }
+
+        // If the best position is not the neighbouring one,
+        // We have to move to its parent that was previously visited
+        // during the steps of the A* algorithm, through the known safe cells
+
+        if (!table.neighbour(cur_pos, best))
+            stupid_move_to_known_target(io, table, router, cur_pos, table[best].parent, has_shield, route);
+
+        // If stone is found in the best cell,
+        // Reporting the success and stopping the algorithm
+
+        const bool is_stone_found = move_then_update(
+                io, cur_pos, best,
+                inf_stone_n, inf_stone_m,
+                has_shield, table,
+                open, closed
+        );
+
+        if (is_stone_found)
+            return true;
+
+        add_known_safe(table, router, cur_pos);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Lifelong Planning A* (LPA*) from the initial cell to the Infinity Stone.
+ * Unknown cells are assumed to be safe, known dangerous cells are blocked.
+ * Costs from the initial cell (g, stored in cell::from_player_cost) and their
+ * one-step lookahead values (rhs) are kept between perception updates,
+ * so after new dangerous cells are found only the affected part of the search is repaired.
+ * Parent of every cell is its neighbour that gives the rhs value,
+ * so the shortest path is constructed with construct_path().
+ */
+
+template <typename extent> class lpa_star {
+    /** Priority of the inconsistent cell: [min(g, rhs) + h, min(g, rhs)] */
+    struct key {
+        int estimate;
+        int cost;
+
+        auto operator<=>(const key&) const = default;
+    };
+
+    /** Order of queued cells by their keys, ties are resolved with indices */
+    struct key_order {
+        std::span<const key> keys;
+
+        bool operator()(const cell_index first, const cell_index second) const {
+            return std::tie(keys[first], first) < std::tie(keys[second], second);
+        }
+    };
+
+    game_table<extent>& _table;
+    cell_index _start;
+    cell_index _goal;
+
+    /** One-step lookahead costs from the initial cell */
+    std::pmr::vector<int> _rhs;
+
+    /** Keys of the queued cells */
+    std::pmr::vector<key> _keys;
+
+    /** Locally inconsistent cells (g != rhs) */
+    indexed_dary_heap<key_order> _open;
+
+    [[nodiscard]] int& g(const cell_index c) { return _table[c].from_player_cost; }
+
+    [[nodiscard]] key calculate_key(const cell_index c) const {
+        const int cost = std::min(_table[c].from_player_cost, _rhs[c]);
+        return { cost + _table[c].to_target_cost, cost };
+    }
+
+    /** Recalculates rhs value of the cell and requeues it if it is inconsistent */
+    void update_cell(const cell_index c) {
+        if (c != _start) {
+            int rhs = INF;
+            cell_index parent = NO_CELL;
+
+            if (!_table[c].dangerous_status()) {
+                for (const auto neighbour : _table.neighbours(c)) {
+                    const int cost = _table[neighbour].from_player_cost;
+
+                    if (!_table[neighbour].dangerous_status() && cost != INF && cost + 1 < rhs) {
+                        rhs = cost + 1;
+                        parent = neighbour;
+                    }
+                }
+            }
+
+            _rhs[c] = rhs;
+            _table[c].parent = parent;
+        }
+
+        if (_open.contains(c))
+            _open.remove(c);
+
+        if (g(c) != _rhs[c]) {
+            _keys[c] = calculate_key(c);
+            _open.push(c);
+        }
+    }
+
+public:
+    /**
+     * Constructs the planner with all cells assumed to be safe
+     * @param table The game table, its costs and parents are managed by the planner
+     * @param start The initial cell
+     * @param goal The cell with the Infinity Stone
+     */
+
+    lpa_star(game_table<extent>& table, const cell_index start, const cell_index goal) :
+        _table(table),
+        _start(start),
+        _goal(goal),
+        _rhs(table.size(), INF, table.resource()),
+        _keys(table.size(), table.resource()),
+        _open(table.size(), key_order { _keys }, table.resource()) {
+        for (cell_index c = 0; c < table.size(); ++c) {
+            table[c].from_player_cost = INF;
+            table[c].to_target_cost = table.distance(c, goal);
+        }
+
+        _rhs[start] = 0;
+        update_cell(start);
+    }
+
+    lpa_star(const lpa_star&) = delete;
+    lpa_star& operator=(const lpa_star&) = delete;
+
+    /** Length of the shortest path to the Infinity Stone, INF if there is no path */
+    [[nodiscard]] int cost() const { return _table[_goal].from_player_cost; }
+
+    /**
+     * Updates the search after the cell was found to be dangerous:
+     * the cell and all its neighbours are requeued if they became inconsistent
+     */
+
+    void block(const cell_index c) {
+        update_cell(c);
+
+        for (const auto neighbour : _table.neighbours(c))
+            update_cell(neighbour);
+    }
+
+    /** Expands inconsistent cells until the shortest path to the Infinity Stone is found */
+    void compute_shortest_path() {
+        while (!_open.empty() && (_keys[_open.top()] < calculate_key(_goal) || _rhs[_goal] != g(_goal))) {
+            const auto c = _open.pop();
+            instrumentation::count_expansion();
+
+            if (g(c) > _rhs[c]) {
+                // Overconsistent cell: its cost is settled
+                g(c) = _rhs[c];
+            } else {
+                // Underconsistent cell: path through it was blocked
+                g(c) = INF;
+                update_cell(c);
+            }
+
+            for (const auto neighbour : _table.neighbours(c))
+                update_cell(neighbour);
+
+            instrumentation::observe_open_size(_open.size());
+        }
+    }
+};
+
+/**
+ * @brief Moves to the specified cell and learns about the surrounding cells.
+ * All perceived cells without any events are known to be safe,
+ * newly found dangerous cells are reported to the planner
+ *
+ * @param io Transport of the interactive protocol
+ * @param cur_pos Current player position
+ * @param new_pos The cell to move to
+ * @param table The game table
+ * @param known A set of cells whose status is known
+ * @param router Router over the known safe cells
+ * @param planner Incremental planner of the path to the Infinity Stone
+ * @return True if new dangerous cells were found, false otherwise
+ * @tparam perception Thanos perception variant of the game
+ */
+
+template <typename perception, typename extent, typename transport> bool move_then_perceive(
+        transport& io,
+        cell_index& cur_pos,
+        const cell_index new_pos,
+        game_table<extent>& table,
+        restricted_cells<extent>& known,
+        travel_router<extent>& router,
+        lpa_star<extent>& planner
+) {
+    // Sends request to move
+    io.move(table.m(new_pos), table.n(new_pos));
+
+    cur_pos = new_pos;
+
+    // Perceived cells are safe, unless they are listed in the response
+
+    auto for_each_perceived = [&](auto&& on_cell) {
+        on_cell(cur_pos);
+
+        for (const auto& [dn, dm] : perception::OFFSETS) {
+            const int n = table.n(cur_pos) + dn;
+            const int m = table.m(cur_pos) + dm;
+
+            if (table.in_borders(n, m))
+                on_cell(table.index(n, m));
+        }
+    };
+
+    for_each_perceived([&](const cell_index c) { known.set(c); });
+
+    bool is_danger_found = false;
+
+    // Handles response and updates the game state with events from the response
+
+    for (const auto& [m, n, status] : io.response()) {
+        const auto c = table.index(n, m);
+        auto& perceived = table[c];
+        const bool was_dangerous = perceived.dangerous_status();
+
+        perceived.cell_status = status;
+        known.set(c);
+
+        if (perceived.dangerous_status() && !was_dangerous) {
+            planner.block(c);
+            is_danger_found = true;
+        }
+    }
+
+    // The Infinity Stone is never added, so routes do not finish the game by accident
+
+    for_each_perceived([&](const cell_index c) {
+        if (!table[c].dangerous_status() && table[c].cell_status != 'I')
+            router.add(c);
+    });
+
+    return is_danger_found;
+}
+
+/**
+ * @brief Attempts to find a path to the Infinity Stone with the incremental planner (LPA*).
+ * The planner assumes that all unknown cells are safe and finds the shortest path.
+ * Player travels through the known safe cells to the last known cell of this path,
+ * learns about the next one and the planner repairs the search.
+ * Once all cells of the shortest path are known to be safe, the path is optimal.
+ *
+ * @param io Transport of the interactive protocol
+ * @param inf_stone_n The row coordinate of the Infinity Stone
+ * @param inf_stone_m The column coordinate of the Infinity Stone
+ * @param table The game table
+ * @return True if a path to the Infinity Stone is found, false otherwise.
+ * @tparam perception Thanos perception variant of the game
+ */
+
+template <typename perception, typename extent, typename transport> bool launch_lpa_star(
+        transport& io,
+        const int inf_stone_n,
+        const int inf_stone_m,
+        game_table<extent>& table
+) {
+    const auto start = table.index(0, 0);
+    const auto inf_stone = table.index(inf_stone_n, inf_stone_m);
+
+    // Initializing the current position to the initial cell
+    auto cur_pos = start;
+
+    restricted_cells<extent> known(table);
+    known.set(inf_stone);
+
+    lpa_star<extent> planner(table, start, inf_stone);
+
+    // Router over the known safe cells
+    travel_router<extent> router(table);
+
+    // Buffers for the planned paths and routes, reserved once for the longest possible path
+    cell_path path(table.resource());
+    path.reserve(table.size());
+
+    cell_path route(table.resource());
+    route.reserve(table.size());
+
+    // Learning about the initial cell's surroundings
+    move_then_perceive<perception>(io, cur_pos, start, table, known, router, planner);
+
+    for (;;) {
+        // The game is cancelled, e.g. the rival solver of the portfolio race has won
+        if (stop_requested(io))
+            return false;
+
+        planner.compute_shortest_path();
+
+        if (planner.cost() == INF)
+            return false;
+
+        // Searching for the first unknown cell of the path, starting from the initial cell
+        construct_path(table, inf_stone, path);
+        const auto unknown = std::ranges::find_if(path.rbegin(), path.rend(), [&](const auto c) {
+            return !known.test(c);
+        });
+
+        // The whole path is known to be safe, so it is the shortest one
+        if (unknown == path.rend())
+            return true;
+
+        // Travelling to the last known cell before it,
+        // the route is abandoned as soon as new dangerous cells are found
+        router.route(cur_pos, *std::prev(unknown), route);
+
+        for (const auto c : route)
+            if (move_then_perceive<perception>(io, cur_pos, c, table, known, router, planner))
+                break;
+    }
+}
+
+/**
+ * @brief Plays the whole game with the judge on the game table of the given dimensions
+ * @param dimensions Dimensions of the game table
+ * @param incremental Whether to use the incremental planner (LPA*) instead of A*
+ * @param io Transport of the interactive protocol
+ * @param resource Memory resource for all storage of the solve
+ */
+
+template <typename extent, typename transport> void play(
+        const extent& dimensions,
+        const bool incremental,
+        transport& io,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+) {
+    const auto [thanos_perception_variant, inf_stone_m, inf_stone_n] = io.start();
+
+    auto table = init_game_table(dimensions, inf_stone_n, inf_stone_m, resource);
+
+    auto launch = [&] {
+        // Perception variant is dispatched once, the planner's perception code is specialized for it
+        if (incremental) {
+            return with_thanos_perception(thanos_perception_variant, [&](const auto perception) {
+                return launch_lpa_star<decltype(perception)>(io, inf_stone_n, inf_stone_m, table);
+            });
+        }
+
+        cell_priority_queue open(table.cells(), table.resource());
+        open.push(table.index(0, 0));
+
+        restricted_cells<extent> closed(table);
+        bool has_shield = false;
+
+        return launch_a_star(io, inf_stone_n, inf_stone_m, has_shield, table, open, closed);
+    };
+
+    if (!launch()) {
+        io.end(-1);
+        return;
+    }
+
+    io.end(table[table.index(inf_stone_n, inf_stone_m)].from_player_cost);
+}
+
+} // namespace astar
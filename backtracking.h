@@ -0,0 +1,517 @@
+#pragma once
+
+#include <iostream>
+#include <ranges>
+#include <vector>
+#include <array>
+#include <cstdint>
+#include <queue>
+#include <deque>
+#include <memory_resource>
+#include <algorithm>
+#include <string>
+#include <string_view>
+
+#include "grid.h"
+#include "bitboard.h"
+#include "transport.h"
+#include "instrumentation.h"
+
+/**
+ * Solver exploring the table with backtracking (optionally goal-directed), the main of the player is in backtracking.cpp
+ */
+
+namespace backtracking {
+
+/**
+ * @brief Represents a cell on the simulation table.
+ * Plain record, coordinates are derived from the cell's index in the table.
+ */
+
+struct cell {
+    /** The cost to move to this cell from the player's initial position */
+    int from_player_cost = INF;
+
+    /** Event of the cell (perception, picked by hero, etc.) */
+    char cell_status = 0;
+
+    /**
+     * Checks whether the cell is dangerous to move
+     * @return true if the cell is dangerous, false otherwise.
+     */
+
+    [[nodiscard]] bool dangerous_status() const { return ::dangerous_status(cell_status); }
+};
+
+/** Simulation table of the backtracking algorithm with the given dimensions */
+template <typename extent> using game_table = grid<cell, extent>;
+
+/** Set of cells: bitboard for the fixed-size tables, row-wise bitboard for the runtime-sized ones */
+template <typename extent> using restricted_cells = cell_set<extent>;
+
+/**
+ * @brief Initializes the game table with the specified coordinates for the Infinity Stone
+ * @param dimensions Dimensions of the game table
+ * @param inf_stone_n The row coordinate of the Infinity Stone
+ * @param inf_stone_m The column coordinate of the Infinity Stone
+ * @param resource Memory resource for the table and the rest of the solve's storage
+ * @return The initialized game table.
+ */
+
+template <typename extent> [[nodiscard]] auto init_game_table(
+        const extent& dimensions,
+        const int inf_stone_n,
+        const int inf_stone_m,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+) {
+    game_table<extent> table(dimensions, resource);
+
+    auto& start = table[table.index(0, 0)];
+    start.cell_status = 'A';
+    start.from_player_cost = 0;
+
+    table[table.index(inf_stone_n, inf_stone_m)].cell_status = 'I';
+    return table;
+}
+
+/**
+ * @brief Makes a move to the specified cell without the response analysis.
+ * Move may be batched by the transport, its response is discarded
+ * @param io Transport of the interactive protocol
+ * @param table The game table
+ * @param pos The cell to move to
+ */
+
+template <typename extent, typename transport> void stupid_move(
+        transport& io,
+        const game_table<extent>& table,
+        const cell_index pos
+) {
+    io.blind_move(table.m(pos), table.n(pos));
+    instrumentation::count_blind_move();
+}
+
+/**
+ * @brief Moves to the specified cell and updates the game state accordingly
+ * @param io Transport of the interactive protocol
+ * @param pos The cell to move to
+ * @param has_shield Indicates whether the player has a shield
+ * @param table The game table
+ * @param visited A set of cells that have been visited
+ * @param danger A set of cells that are known to be dangerous
+ * @return True if the player has reached the Infinity Stone, false otherwise
+ */
+
+template <typename extent, typename transport> bool move_then_update(
+        transport& io,
+        const cell_index pos,
+        bool& has_shield,
+        game_table<extent>& table,
+        restricted_cells<extent>& visited,
+        restricted_cells<extent>& danger
+) {
+    // Sends request to move
+    io.move(table.m(pos), table.n(pos));
+    visited.set(pos);
+
+    instrumentation::count_expansion();
+    instrumentation::observe_closed_set(visited);
+
+    // Picks shield if any
+    if (table[pos].cell_status == 'S')
+        has_shield = true;
+
+    // Handles response and updates the game state with events from the response
+
+    for (const auto& [m, n, status] : io.response()) {
+        const auto c = table.index(n, m);
+        table[c].cell_status = status;
+
+        if (table[c].dangerous_status())
+            danger.set(c);
+    }
+
+    // If we have reached the stone, report back
+    if (table[pos].cell_status == 'I')
+        return true;
+
+    // Continue to explore unless stone is found
+    return false;
+}
+
+/** @brief Frame of the depth-first search: the cell and the index of its next neighbour to try */
+struct dfs_frame {
+    cell_index c;
+    std::uint8_t next_neighbour;
+};
+
+/**
+ * @brief Utilizes a backtracking depth-first search algorithm to find a path to the Infinity Stone.
+ * Algorithm will explore the whole map, trying to reach every cell, if possible.
+ * Algorithm considers cases where the shield was picked, meaning that it will analyze
+ * if Infinity Stone can be reached with the shield (ignoring dangerous cells by Hulk and Thor).
+ * Search is iterative with the explicit stack of frames, reserved once for the whole table,
+ * so it works in the constant call stack space on large maps.
+ * Neighbours are tried in the order of table.neighbours() and
+ * the player returns to the cell after every explored neighbour.
+ *
+ * @param io Transport of the interactive protocol
+ * @param start The initial cell
+ * @param has_shield Indicates whether the player has a shield
+ * @param table The game table
+ * @param visited A set of cells that have been visited
+ * @param danger A set of cells that are known to be dangerous
+ * @return True if a path to the Infinity Stone is found, false otherwise
+ */
+
+template <typename extent, typename transport> bool backtracking_dfs(
+        transport& io,
+        const cell_index start,
+        bool& has_shield,
+        game_table<extent>& table,
+        restricted_cells<extent>& visited,
+        restricted_cells<extent>& danger
+) {
+    // Every cell is entered at most once, so the stack never exceeds the table
+    std::pmr::vector<dfs_frame> stack(table.resource());
+    stack.reserve(table.size());
+
+    // Checks whether the stone is in the initial position
+    bool has_solution = move_then_update(io, start, has_shield, table, visited, danger);
+    stack.push_back({ start, 0 });
+
+    while (!stack.empty()) {
+        // The game is cancelled, e.g. the rival solver of the portfolio race has won
+        if (stop_requested(io))
+            return false;
+
+        auto& frame = stack.back();
+        const auto next = table.neighbours(frame.c);
+
+        // All neighbours are explored, returning to the previous cell
+        if (frame.next_neighbour == next.size()) {
+            stack.pop_back();
+
+            if (!stack.empty())
+                stupid_move(io, table, stack.back().c);
+
+            continue;
+        }
+
+        const auto c = next[frame.next_neighbour++];
+
+        // Exploring the neighbouring cell, if it was unvisited before and
+        // we may reach it without any danger
+
+        if (!danger.test(c) && !visited.test(c)) {
+            if (move_then_update(io, c, has_shield, table, visited, danger))
+                has_solution = true;
+
+            stack.push_back({ c, 0 });
+            instrumentation::observe_open_size(stack.size());
+        }
+    }
+
+    return has_solution;
+}
+
+/**
+ * @brief Updates the distances from the player's initial position through the visited cells
+ * (from_player_cost) after the cell was visited. Distances only decrease when cells are added,
+ * so only the cells whose distance is improved are processed
+ * @param table The game table
+ * @param visited A set of cells that have been visited, including the new one
+ * @param c The new visited cell
+ * @param queue Buffer for the cells with the improved distance
+ */
+
+template <typename extent> void relax_known_distances(
+        game_table<extent>& table,
+        const restricted_cells<extent>& visited,
+        const cell_index c,
+        std::pmr::vector<cell_index>& queue
+) {
+    for (const auto neighbour : table.neighbours(c))
+        if (visited.test(neighbour))
+            table[c].from_player_cost = std::min(table[c].from_player_cost, table[neighbour].from_player_cost + 1);
+
+    queue.clear();
+    queue.push_back(c);
+
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        const auto cur_pos = queue[head];
+        const auto cost = table[cur_pos].from_player_cost + 1;
+
+        for (const auto neighbour : table.neighbours(cur_pos)) {
+            if (visited.test(neighbour) && cost < table[neighbour].from_player_cost) {
+                table[neighbour].from_player_cost = cost;
+                queue.push_back(neighbour);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Goal-directed version of the backtracking depth-first search.
+ * Neighbours are tried in the order of the Manhattan distance to the Infinity Stone,
+ * so the stone is usually reached with the first descent. Distances through the visited cells
+ * are kept up to date, and the distance to the stone is the best known path length.
+ * A cell is not explored if the Manhattan distances from the initial position to the cell
+ * and from the cell to the stone together are not shorter than the best known path,
+ * because no path through the cell may improve it. Cells of any shorter path are never pruned,
+ * so the search visits all of them, and the reported cost is the same as after the whole map is explored.
+ * The player returns to the previous cell only when there is another neighbour to explore from it.
+ *
+ * @param io Transport of the interactive protocol
+ * @param start The initial cell
+ * @param inf_stone The cell with the Infinity Stone
+ * @param has_shield Indicates whether the player has a shield
+ * @param table The game table
+ * @param visited A set of cells that have been visited
+ * @param danger A set of cells that are known to be dangerous
+ * @return True if a path to the Infinity Stone is found, false otherwise
+ */
+
+template <typename extent, typename transport> bool goal_directed_dfs(
+        transport& io,
+        const cell_index start,
+        const cell_index inf_stone,
+        bool& has_shield,
+        game_table<extent>& table,
+        restricted_cells<extent>& visited,
+        restricted_cells<extent>& danger
+) {
+    // Every cell is entered at most once, so the stack never exceeds the table
+    std::pmr::vector<dfs_frame> stack(table.size(), table.resource());
+    std::pmr::vector<cell_index> queue(table.resource());
+    queue.reserve(table.size());
+
+    // Number of frames and the frame of the cell where the player stands
+    std::size_t depth = 0, position = 0;
+
+    auto to_stone = [&](const cell_index c) {
+        return table.distance(c, inf_stone);
+    };
+
+    auto lower_bound = [&](const cell_index c) {
+        return table.distance(start, c) + to_stone(c);
+    };
+
+    // Checks whether the stone is in the initial position
+    bool has_solution = move_then_update(io, start, has_shield, table, visited, danger);
+    stack[depth++] = { start, 0 };
+
+    while (depth) {
+        // The game is cancelled, e.g. the rival solver of the portfolio race has won
+        if (stop_requested(io))
+            return false;
+
+        auto& frame = stack[depth - 1];
+        const auto next = table.neighbours(frame.c);
+
+        // All neighbours are explored, the player stays until the next cell to explore is found
+        if (frame.next_neighbour == next.size()) {
+            --depth;
+            continue;
+        }
+
+        // Neighbours ordered by the distance to the stone, ties in the order of table.neighbours();
+        // the insertion sort is stable without the temporary buffer of std::stable_sort
+        std::array<cell_index, 4> ordered {};
+
+        for (std::size_t amount = 0; amount < next.size(); ++amount) {
+            auto slot = amount;
+
+            for (; slot && to_stone(ordered[slot - 1]) > to_stone(next[amount]); --slot)
+                ordered[slot] = ordered[slot - 1];
+
+            ordered[slot] = next[amount];
+        }
+
+        const auto c = ordered[frame.next_neighbour++];
+
+        if (danger.test(c) || visited.test(c))
+            continue;
+
+        // No path through the cell is shorter than the best known one
+        if (lower_bound(c) >= table[inf_stone].from_player_cost)
+            continue;
+
+        // Returning to the cell of the frame
+        while (position + 1 > depth)
+            stupid_move(io, table, stack[--position].c);
+
+        if (move_then_update(io, c, has_shield, table, visited, danger))
+            has_solution = true;
+
+        relax_known_distances(table, visited, c, queue);
+
+        position = depth;
+        stack[depth++] = { c, 0 };
+        instrumentation::observe_open_size(depth);
+    }
+
+    return has_solution;
+}
+
+/**
+ * @brief Utilizes a breadth-first search algorithm to construct the costs to find the Infinity Stone.
+ * Algorithm updates the costs to reach every cell, until it finds the Infinity Stone.
+ * Queue-based version, used on the tables larger than MAX_FLOOD_FILL_CELLS
+ * and kept as the reference for the bit-parallel flood fill.
+ * Note that this procedure requires the map to be explored with depth-first search
+ * before applying the function, so all reachable cells are known to be safe
+ * @param table The game table
+ * @param known_safe A set of cells that are known to be safe (visited by the depth-first search)
+ */
+
+template <typename extent> void backtracking_bfs(
+        game_table<extent>& table,
+        const restricted_cells<extent>& known_safe
+) {
+    // Queue of neighboring cells to visit
+    std::queue<cell_index, std::pmr::deque<cell_index>> q(table.resource());
+
+    // Previously visited cells
+    restricted_cells<extent> visited(table);
+
+    q.push(table.index(0, 0));
+    visited.set(table.index(0, 0));
+
+    while (!q.empty()) {
+        // Picking the next cell to visit
+        const auto cur_pos = q.front(); q.pop();
+
+        // All possible neighbouring positions
+        const auto next = table.neighbours(cur_pos);
+
+        // Picking all neighboring cells, that were unvisited before and that we may reach without any danger.
+        // At the last step, we are incrementing the cost from the initial position of the player,
+        // and pushing the neighboring cell to the queue in order to move to its neighbors in the next iterations.
+        // Cells are marked as visited once they are queued, so every cell is queued only once
+        // (otherwise queue grows with the number of shortest paths, exponentially on large open maps)
+
+        auto valid_neighbours = next
+                | std::views::filter([&](const auto c) {
+                    return known_safe.test(c) && !visited.test(c);
+                })
+                | std::views::transform([&](const auto c) {
+                    visited.set(c);
+                    table[c].from_player_cost = table[cur_pos].from_player_cost + 1;
+                    q.push(c);
+                    return c;
+                });
+
+        // Moving through neighboring cells until we find the one with the Infinity Stone
+        const bool is_stone_found = std::ranges::any_of(
+                valid_neighbours,
+                [&](const auto c) { return table[c].cell_status == 'I'; }
+        );
+
+        if (is_stone_found)
+            return;
+    }
+}
+
+/**
+ * @brief Bit-parallel version of the breadth-first search.
+ * The whole frontier is expanded at once with shifts and masks (whole words of the rows
+ * for the runtime-sized tables), one distance layer per step,
+ * so the distance to the Infinity Stone is the number of layers before the stone is reached.
+ * Note that this procedure requires the map to be explored with depth-first search
+ * before applying the function, so all reachable cells are known to be safe
+ * @param table The game table
+ * @param known_safe A set of cells that are known to be safe (visited by the depth-first search)
+ * @param inf_stone The cell with the Infinity Stone
+ */
+
+template <typename extent> void backtracking_flood_fill(
+        game_table<extent>& table,
+        const restricted_cells<extent>& known_safe,
+        const cell_index inf_stone
+) {
+    restricted_cells<extent> start(table);
+    start.set(table.index(0, 0));
+
+    const auto distance = layered_flood_fill(start, known_safe, [&](int, const auto& layer) {
+        return layer.test(inf_stone);
+    });
+
+    if (distance != -1)
+        table[inf_stone].from_player_cost = distance;
+}
+
+/**
+ * Largest table for the bit-parallel flood fill. Every layer scans all rows of its frontier,
+ * so the flood fill costs the number of layers times the number of rows, and on larger tables
+ * the queue-based search is faster (see bench/flood_fill_bench.cpp)
+ */
+constexpr std::size_t MAX_FLOOD_FILL_CELLS = 512 * 512;
+
+/**
+ * @brief Attempts to find a path to the Infinity Stone using backtracking DFS and BFS algorithms
+ * @param io Transport of the interactive protocol
+ * @param table The game table
+ * @param inf_stone_n The row coordinate of the Infinity Stone
+ * @param inf_stone_m The column coordinate of the Infinity Stone
+ * @param goal_directed Whether to explore only the cells that may improve the path to the stone
+ * @return True if a path to the Infinity Stone is found, false otherwise
+ */
+
+template <typename extent, typename transport> bool launch_backtracking(
+        transport& io,
+        game_table<extent>& table,
+        const int inf_stone_n,
+        const int inf_stone_m,
+        const bool goal_directed
+) {
+    bool has_shield = false;
+    restricted_cells<extent> visited(table);
+    restricted_cells<extent> danger(table);
+
+    const auto start = table.index(0, 0);
+    const auto inf_stone = table.index(inf_stone_n, inf_stone_m);
+
+    const auto has_solution = goal_directed
+            ? goal_directed_dfs(io, start, inf_stone, has_shield, table, visited, danger)
+            : backtracking_dfs(io, start, has_shield, table, visited, danger);
+
+    if (!has_solution) return false;
+
+    // Cells visited by the depth-first search are known to be safe
+    if (table.size() > MAX_FLOOD_FILL_CELLS)
+        backtracking_bfs(table, visited);
+    else
+        backtracking_flood_fill(table, visited, inf_stone);
+
+    return true;
+}
+
+/**
+ * @brief Plays the whole game with the judge on the game table of the given dimensions
+ * @param dimensions Dimensions of the game table
+ * @param goal_directed Whether to use the goal-directed search instead of the exploration of the whole map
+ * @param io Transport of the interactive protocol
+ * @param resource Memory resource for all storage of the solve
+ */
+
+template <typename extent, typename transport> void play(
+        const extent& dimensions,
+        const bool goal_directed,
+        transport& io,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+) {
+    // Cells are explored one by one, so the Thanos perception variant is not used
+    const auto [thanos_perception_variant, inf_stone_m, inf_stone_n] = io.start();
+
+    auto table = init_game_table(dimensions, inf_stone_n, inf_stone_m, resource);
+
+    if (!launch_backtracking(io, table, inf_stone_n, inf_stone_m, goal_directed)) {
+        io.end(-1);
+        return;
+    }
+
+    io.end(table[table.index(inf_stone_n, inf_stone_m)].from_player_cost);
+}
+
+} // namespace backtracking
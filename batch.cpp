@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "arena.h"
+#include "scheduler.h"
+#include "simulator.h"
+#include "solvers.h"
+
+/**
+ * Solves the world with the solver in the same thread through direct_transport
+ * @param solver Name of the solver: astar, astar-incremental, backtracking or backtracking-goal
+ * @param world The world of the game
+ * @param resource Memory resource for the solver's storage
+ * @param buffers Buffers of the simulator's game, reused by the following games
+ * @return statistics of the game
+ */
+
+[[nodiscard]] run_result solve_world(
+        const std::string_view solver,
+        const game_world& world,
+        std::pmr::memory_resource* resource,
+        game_buffers& buffers
+) {
+    return run_direct(world, buffers, [&](auto& io) { play_solver(solver, world.size, io, resource); });
+}
+
+/** @brief Job of the batch: the world solved with the solver */
+struct batch_job {
+    std::size_t world;
+    std::string_view solver;
+};
+
+/**
+ * @brief Storage of the worker: the arena for the solver's storage, released after every job,
+ * and the buffers of the simulator's games. It is never shared with other workers, so it needs
+ * no synchronization, and once it has grown to the largest solve the workers make no calls
+ * into the global allocator.
+ */
+
+struct alignas(64) worker_storage {
+    solve_arena arena;
+    game_buffers buffers;
+};
+
+/**
+ * Usage: batch [--threads N] [--solver NAME[,NAME...]] [--static] [world-file...]
+ * Solvers: astar, astar-incremental, backtracking, backtracking-goal or all.
+ *
+ * Loads the world descriptions (written with simulator --dump) from the files or from stdin,
+ * solves every world with every given solver in-process against the simulator
+ * with the fixed-size pool of workers (hardware concurrency by default)
+ * and prints one result line per job in the order of the worlds.
+ * Jobs are balanced with work stealing (--static splits them into fixed blocks instead).
+ * The summary with the throughput and the utilisation of every worker is printed to stderr, e.g.
+ * simulator --seeds 10000 --dump > worlds.txt && batch --threads 8 --solver all worlds.txt
+ * Verdicts other than accepted are only reported in the result lines and the summary,
+ * the exit code is 1 only for the errors of the tool: unknown solver, unreadable or invalid world files.
+ *
+ * Build: g++ -std=c++20 -O2 -pthread -o batch batch.cpp
+ */
+
+int main(const int argc, const char* const argv[]) {
+    std::vector<std::string_view> solvers;
+    int threads = static_cast<int>(std::thread::hardware_concurrency());
+    auto policy = schedule::work_stealing;
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        if (arg == "--solver" && i + 1 < argc) {
+            if (!add_solvers(argv[++i], solvers, "batch"))
+                return 1;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::atoi(argv[++i]);
+        } else if (arg == "--static") {
+            policy = schedule::static_split;
+        } else {
+            files.emplace_back(arg);
+        }
+    }
+
+    if (solvers.empty())
+        solvers.push_back(SOLVERS[0]);
+
+    std::vector<game_world> worlds;
+
+    if (!load_game_worlds(files, worlds, "batch"))
+        return 1;
+
+    std::vector<batch_job> jobs;
+    jobs.reserve(worlds.size() * solvers.size());
+
+    for (std::size_t world = 0; world < worlds.size(); ++world)
+        for (const auto solver : solvers)
+            jobs.push_back({ world, solver });
+
+    const auto workers = static_cast<std::size_t>(std::max(threads, 1));
+    std::vector<worker_storage> storages(workers);
+    std::vector<worker_load> loads(workers);
+    std::vector<run_result> results(jobs.size());
+
+    const auto start = std::chrono::steady_clock::now();
+
+    run_scheduled(policy, jobs.size(), loads, [&](const std::size_t worker, const std::size_t job) {
+        auto& [arena, buffers] = storages[worker];
+        results[job] = solve_world(jobs[job].solver, worlds[jobs[job].world], arena.resource(), buffers);
+        arena.release();
+    });
+
+    const auto wall_time = std::chrono::steady_clock::now() - start;
+
+    std::map<std::string_view, int> verdicts;
+    std::size_t moves = 0;
+
+    for (std::size_t i = 0; i < jobs.size(); ++i) {
+        const auto& result = results[i];
+        ++verdicts[to_string(result.outcome)];
+        moves += result.moves;
+
+        std::cout << "world " << jobs[i].world << ", " << jobs[i].solver << ": " << to_string(result.outcome)
+                  << ", reported " << result.reported << ", expected " << result.expected
+                  << ", moves " << result.moves << '\n';
+    }
+
+    std::cout.flush();
+
+    auto milliseconds = [](const std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    };
+
+    for (const auto& [outcome, amount] : verdicts)
+        std::cerr << outcome << ": " << amount << std::endl;
+
+    std::cerr << "moves: " << moves << std::endl
+              << "wall time: " << milliseconds(wall_time) << " ms" << std::endl
+              << "throughput: " << static_cast<double>(jobs.size()) * 1000 / milliseconds(wall_time) << " jobs/s" << std::endl;
+
+    for (std::size_t w = 0; w < workers; ++w)
+        std::cerr << "worker " << w << ": " << loads[w].jobs << " jobs (" << loads[w].stolen << " stolen), busy "
+                  << milliseconds(loads[w].busy_time) << " ms, finished at " << milliseconds(loads[w].active_time)
+                  << " ms, utilisation " << loads[w].utilisation(wall_time) * 100 << "%" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,145 @@
+/**
+ * Benchmark of the A* node expansion cost.
+ * Compares the flat index-based game table from astar.h with the previous
+ * representation, where every cell was a std::shared_ptr with a shared_ptr parent.
+ * Both engines run the same offline A* (the whole map is known, no I/O)
+ * over the same randomly generated maps of the judge's size.
+ *
+ * Build: g++ -std=c++20 -O2 -o expansion_bench bench/expansion_bench.cpp
+ */
+
+#include "offline.h"
+
+#include <memory>
+#include <unordered_set>
+
+/** Previous shared_ptr-based representation of the game table */
+
+namespace legacy {
+    struct cell;
+
+    using cell_ptr = std::shared_ptr<cell>;
+    using game_table_row = std::vector<cell_ptr>;
+    using game_table = std::vector<game_table_row>;
+
+    struct cell {
+        int n;
+        int m;
+        int from_player_cost = INF;
+        int to_target_cost = INF;
+        char cell_status = 0;
+        cell_ptr parent;
+        std::unordered_set<char> possibly_picked_by;
+
+        [[nodiscard]] int sum_cost() const { return from_player_cost + to_target_cost; }
+
+        [[nodiscard]] bool dangerous_status() const {
+            return cell_status == 'P' || cell_status == 'M' || cell_status == 'H' || cell_status == 'T';
+        }
+    };
+
+    struct cell_less {
+        bool operator()(const cell_ptr& first, const cell_ptr& second) const {
+            if (first->sum_cost() != second->sum_cost())
+                return first->sum_cost() < second->sum_cost();
+
+            if (first->to_target_cost != second->to_target_cost)
+                return first->to_target_cost < second->to_target_cost;
+
+            if (first->from_player_cost != second->from_player_cost)
+                return first->from_player_cost < second->from_player_cost;
+
+            if (first->n != second->n)
+                return first->n < second->n;
+
+            return first->m < second->m;
+        }
+    };
+
+    struct cell_hash {
+        std::size_t operator()(const cell_ptr& cell) const noexcept {
+            return std::hash<int>()(cell->n) * 31 + std::hash<int>()(cell->m);
+        }
+    };
+
+    using cell_priority_queue = std::set<cell_ptr, cell_less>;
+    using restricted_cells = std::unordered_set<cell_ptr, cell_hash>;
+
+    bool in_borders(const int n, const int m) {
+        return n >= 0 && n < TABLE_SIZE && m >= 0 && m < TABLE_SIZE;
+    }
+
+    void open_neighbours(
+            const cell_ptr& cur_pos,
+            const int inf_stone_n,
+            const int inf_stone_m,
+            game_table& table,
+            cell_priority_queue& open
+    ) {
+        auto update_then_check_cell = [&](const int cn, const int cm) {
+            if (in_borders(cn, cm) && !table[cn][cm]->dangerous_status()) {
+                const int new_from_player_cost = cur_pos->from_player_cost + 1;
+
+                if (new_from_player_cost < table[cn][cm]->from_player_cost) {
+                    open.erase(table[cn][cm]);
+                    table[cn][cm]->from_player_cost = new_from_player_cost;
+                    table[cn][cm]->to_target_cost = manhattan_distance(cn, cm, inf_stone_n, inf_stone_m);
+                    table[cn][cm]->parent = cur_pos;
+                    open.insert(table[cn][cm]);
+                }
+            }
+        };
+
+        update_then_check_cell(cur_pos->n - 1, cur_pos->m);
+        update_then_check_cell(cur_pos->n + 1, cur_pos->m);
+        update_then_check_cell(cur_pos->n, cur_pos->m - 1);
+        update_then_check_cell(cur_pos->n, cur_pos->m + 1);
+    }
+
+    /** Offline A* over the fully known map, returns the number of expanded nodes */
+    std::size_t solve(const world& w) {
+        const int inf_stone_n = w.inf_stone_n;
+        const int inf_stone_m = w.inf_stone_m;
+        game_table table(TABLE_SIZE, game_table_row(TABLE_SIZE));
+
+        for (int i = 0; i < TABLE_SIZE; ++i)
+            for (int q = 0; q < TABLE_SIZE; ++q)
+                table[i][q] = std::make_shared<cell>(cell { i, q, INF, INF, w.cells[i * TABLE_SIZE + q], nullptr, {} });
+
+        table[0][0]->from_player_cost = 0;
+        table[0][0]->to_target_cost = manhattan_distance(0, 0, inf_stone_n, inf_stone_m);
+
+        cell_priority_queue open;
+        restricted_cells closed;
+        open.insert(table[0][0]);
+
+        std::size_t expansions = 0;
+
+        while (!open.empty()) {
+            auto best = *open.begin();
+            open.erase(open.begin());
+
+            if (closed.contains(best))
+                continue;
+
+            closed.insert(best);
+            ++expansions;
+
+            if (best->cell_status == 'I')
+                break;
+
+            open_neighbours(best, inf_stone_n, inf_stone_m, table, open);
+        }
+
+        return expansions;
+    }
+}
+
+int main() {
+    const auto worlds = generate_worlds(10000, 42);
+
+    run("shared_ptr table", worlds, 20, legacy::solve);
+    // Open list is pinned to std::set as in the legacy engine, so only the table representation differs
+    run("flat table", worlds, 20, solve<set_queue>);
+    return 0;
+}
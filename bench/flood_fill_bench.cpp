@@ -0,0 +1,89 @@
+/**
+ * Benchmark of the final distance computation of the backtracking solver.
+ * Compares the queue-based breadth-first search with the bit-parallel flood fill
+ * (bitboard for the judge's table, row-wise 64-bit words for the large ones),
+ * the crossover between them is the limit of the flood fill in the solver (MAX_FLOOD_FILL_CELLS).
+ * Both run over the same randomly generated maps, where all safe cells
+ * are considered to be visited by the depth-first search.
+ *
+ * Build: g++ -std=c++20 -O2 -o flood_fill_bench bench/flood_fill_bench.cpp
+ */
+
+#include "../backtracking.h"
+
+#include "worlds.h"
+
+#include <chrono>
+
+using namespace backtracking;
+
+/**
+ * Runs both searches over all maps of the given dimensions,
+ * checks that the distances are the same and prints the cost of a single search
+ */
+
+template <typename extent> void run_all(
+        const char* name,
+        const extent& dimensions,
+        const std::vector<world>& worlds,
+        const int rounds
+) {
+    std::vector<game_table<extent>> tables;
+    std::vector<restricted_cells<extent>> known_safe;
+
+    for (const auto& w : worlds) {
+        auto& table = tables.emplace_back(init_game_table(dimensions, w.inf_stone_n, w.inf_stone_m));
+        auto& safe = known_safe.emplace_back(table);
+
+        for (cell_index c = 0; c < table.size(); ++c)
+            if (!dangerous_status(w.cells[c]))
+                safe.set(c);
+    }
+
+    auto measure = [&](const char* search_name, auto&& search) {
+        std::vector<int> distances;
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int round = 0; round < rounds; ++round) {
+            distances.clear();
+
+            for (std::size_t i = 0; i < worlds.size(); ++i) {
+                auto& table = tables[i];
+                const auto inf_stone = table.index(worlds[i].inf_stone_n, worlds[i].inf_stone_m);
+
+                table[inf_stone].from_player_cost = INF;
+                search(table, known_safe[i], inf_stone);
+                distances.push_back(table[inf_stone].from_player_cost);
+            }
+        }
+
+        const auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start);
+        const auto searches = static_cast<double>(worlds.size()) * rounds;
+
+        std::cout << name << ", " << search_name << ": "
+                  << elapsed.count() / searches << " us per search" << std::endl;
+
+        return distances;
+    };
+
+    const auto queue_distances = measure("queue bfs", [](auto& table, const auto& safe, cell_index) {
+        backtracking_bfs(table, safe);
+    });
+
+    const auto flood_distances = measure("flood fill", [](auto& table, const auto& safe, const cell_index inf_stone) {
+        backtracking_flood_fill(table, safe, inf_stone);
+    });
+
+    if (queue_distances != flood_distances)
+        std::cout << name << ": distances mismatch" << std::endl;
+}
+
+int main() {
+    run_all("9x9", fixed_extent<TABLE_SIZE>(), generate_worlds(10000, 42), 20);
+    run_all("64x64", dynamic_extent(64, 64), generate_worlds(200, 42, 64), 10);
+    run_all("256x256", dynamic_extent(256, 256), generate_worlds(20, 42, 256), 5);
+    run_all("512x512", dynamic_extent(512, 512), generate_worlds(8, 42, 512), 3);
+    run_all("768x768", dynamic_extent(768, 768), generate_worlds(4, 42, 768), 2);
+    run_all("1024x1024", dynamic_extent(1024, 1024), generate_worlds(4, 42, 1024), 2);
+    return 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * Common parts of the A* benchmarks:
+ * the offline A* (the whole map is known, no I/O) on top of astar.h
+ */
+
+#pragma once
+
+#include "../astar.h"
+
+#include "worlds.h"
+
+#include <chrono>
+
+using namespace astar;
+
+/**
+ * Offline A* with the flat game table of the given dimensions
+ * @return number of expanded nodes
+ */
+
+template <typename open_list, typename extent> std::size_t solve(const world& w, const extent& dimensions) {
+    auto table = init_game_table(dimensions, w.inf_stone_n, w.inf_stone_m);
+
+    for (cell_index c = 0; c < table.size(); ++c)
+        table[c].cell_status = w.cells[c];
+
+    open_list open(table.cells());
+    restricted_cells<extent> closed(table);
+    open.push(table.index(0, 0));
+
+    std::size_t expansions = 0;
+
+    while (!open.empty()) {
+        const auto best = open.pop();
+
+        if (closed.test(best))
+            continue;
+
+        closed.set(best);
+        ++expansions;
+
+        if (table[best].cell_status == 'I')
+            break;
+
+        open_neighbours(best, w.inf_stone_n, w.inf_stone_m, table, open);
+    }
+
+    return expansions;
+}
+
+/**
+ * Offline A* with the flat game table,
+ * judge's table size is known at compile time, others are runtime-sized
+ * @return number of expanded nodes
+ */
+
+template <typename open_list> std::size_t solve(const world& w) {
+    if (w.size == TABLE_SIZE)
+        return solve<open_list>(w, fixed_extent<TABLE_SIZE>());
+
+    return solve<open_list>(w, dynamic_extent(w.size, w.size));
+}
+
+/** Runs the solver over all maps and prints the cost of a single expansion */
+template <typename F> void run(const char* name, const std::vector<world>& worlds, const int rounds, F&& solve) {
+    std::size_t expansions = 0;
+    const auto start = std::chrono::steady_clock::now();
+
+    for (int round = 0; round < rounds; ++round)
+        for (const auto& w : worlds)
+            expansions += solve(w);
+
+    const auto elapsed = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start);
+
+    std::cout << name << ": " << expansions << " expansions, "
+              << elapsed.count() / static_cast<double>(expansions) << " ns per expansion" << std::endl;
+}
@@ -0,0 +1,26 @@
+/**
+ * Benchmark of the A* open lists.
+ * Runs the same offline A* with every open list over the same randomly generated maps.
+ *
+ * Build: g++ -std=c++20 -O2 -o open_list_bench bench/open_list_bench.cpp
+ */
+
+#include "offline.h"
+
+/** Runs all open lists over the same maps */
+void run_all(const std::vector<world>& worlds, const int rounds) {
+    std::cout << worlds.size() << " maps " << worlds.front().size << 'x' << worlds.front().size << std::endl;
+
+    run("std::set", worlds, rounds, solve<set_queue>);
+    run("bucket queue", worlds, rounds, solve<bucket_queue>);
+    run("binary heap", worlds, rounds, solve<dary_heap_queue<2>>);
+    run("4-ary heap", worlds, rounds, solve<dary_heap_queue<4>>);
+    run("8-ary heap", worlds, rounds, solve<dary_heap_queue<8>>);
+}
+
+int main() {
+    run_all(generate_worlds(10000, 42), 20);
+    run_all(generate_worlds(20, 42, 256), 5);
+    run_all(generate_worlds(4, 42, 1024), 1);
+    return 0;
+}
@@ -0,0 +1,138 @@
+/**
+ * Benchmark of parsing the judge's responses.
+ * Compares the iostream path (operator>> of the unsynchronized file stream, as std::cin was used)
+ * with the protocol_reader over read(2). Response streams are recorded from the simulator:
+ * responses to the moves to every safe cell of the generated worlds.
+ * Both parsers read the same file and their checksums have to match.
+ *
+ * Build: g++ -std=c++20 -O2 -pthread -o parser_bench bench/parser_bench.cpp
+ */
+
+#include "../protocol.h"
+#include "../simulator.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+
+/** @brief Recorded stream of responses */
+struct recorded_stream {
+    std::string path;
+    std::size_t responses = 0;
+    std::size_t bytes = 0;
+};
+
+/**
+ * Records responses to the moves to every safe cell of the generated worlds into the file
+ * @param path The file for the responses
+ * @param size Size of the square table
+ * @param seeds Number of worlds for both Thanos perception variants
+ */
+
+[[nodiscard]] recorded_stream record(const std::string& path, const int size, const int seeds) {
+    recorded_stream stream { path };
+    std::ofstream file(path, std::ios::binary);
+    std::string response;
+
+    for (int seed = 0; seed < seeds; ++seed) {
+        for (int variant = 1; variant <= 2; ++variant) {
+            std::mt19937 rng(seed);
+            const auto world = generate_game_world(rng, size, variant);
+
+            for (int n = 0; n < size; ++n) {
+                for (int m = 0; m < size; ++m) {
+                    if (dangerous_status(world.status(n, m)))
+                        continue;
+
+                    perception_response(world, n, m, response);
+                    file << response;
+
+                    ++stream.responses;
+                    stream.bytes += response.size();
+                }
+            }
+        }
+    }
+
+    return stream;
+}
+
+/** Parses all responses with iostream, returns the checksum of the parsed values */
+[[nodiscard]] std::size_t parse_with_iostream(const recorded_stream& stream) {
+    std::ifstream file(stream.path, std::ios::binary);
+    std::size_t checksum = 0;
+
+    for (std::size_t i = 0; i < stream.responses; ++i) {
+        int response_size = 0;
+        file >> response_size;
+
+        while (response_size--) {
+            int n = 0, m = 0;
+            char status = 0;
+            file >> m >> n >> status;
+            checksum += m * 31 + n * 7 + status;
+        }
+    }
+
+    return checksum;
+}
+
+/** Parses all responses with protocol_reader, returns the checksum of the parsed values */
+[[nodiscard]] std::size_t parse_with_reader(const recorded_stream& stream) {
+    const int fd = ::open(stream.path.c_str(), O_RDONLY);
+    protocol_reader in(fd);
+    std::size_t checksum = 0;
+
+    for (std::size_t i = 0; i < stream.responses; ++i) {
+        int response_size = in.read_int();
+
+        while (response_size--) {
+            const int m = in.read_int();
+            const int n = in.read_int();
+            const char status = in.read_char();
+            checksum += m * 31 + n * 7 + status;
+        }
+    }
+
+    ::close(fd);
+    return checksum;
+}
+
+/** Runs both parsers over the stream and prints the cost of a single response */
+void run_all(const char* name, const recorded_stream& stream, const int rounds) {
+    auto measure = [&](const char* parser_name, auto&& parse) {
+        std::size_t checksum = 0;
+        const auto start = std::chrono::steady_clock::now();
+
+        for (int round = 0; round < rounds; ++round)
+            checksum = parse(stream);
+
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+        const auto responses = static_cast<double>(stream.responses) * rounds;
+        const auto megabytes = static_cast<double>(stream.bytes) * rounds / (1 << 20);
+
+        std::cout << name << ", " << parser_name << ": "
+                  << elapsed.count() * 1e9 / responses << " ns per response, "
+                  << megabytes / elapsed.count() << " MB/s" << std::endl;
+
+        return checksum;
+    };
+
+    const auto iostream_checksum = measure("iostream", parse_with_iostream);
+    const auto reader_checksum = measure("protocol_reader", parse_with_reader);
+
+    if (iostream_checksum != reader_checksum)
+        std::cout << name << ": checksums mismatch" << std::endl;
+}
+
+int main() {
+    const auto judge_stream = record("/tmp/parser_bench_9.txt", TABLE_SIZE, 2000);
+    const auto large_stream = record("/tmp/parser_bench_64.txt", 64, 50);
+
+    run_all("9x9", judge_stream, 10);
+    run_all("64x64", large_stream, 10);
+
+    std::remove(judge_stream.path.c_str());
+    std::remove(large_stream.path.c_str());
+    return 0;
+}
@@ -0,0 +1,229 @@
+/**
+ * Benchmark of the whole solvers over the fixed seeded corpus of generated worlds.
+ * Every solver plays in-process against the local simulator with direct calls, all worlds of the corpus
+ * are generated with the judge's rules for both Thanos perception variants.
+ * Results are grouped by the solver, the table size, the perception variant
+ * and whether the Infinity Stone is reachable, and printed as JSON:
+ * moves, expansions (different cells entered), wall-clock time per solve,
+ * allocations per solve and p50/p99 latency of the move decision.
+ * Solves of every solver share one arena (released after every solve), as in the batch solver;
+ * with --no-arena solvers allocate from the default resource.
+ *
+ * Usage: solver_bench [--quick] [--no-arena] [--output FILE]
+ * Build: g++ -std=c++20 -O2 -pthread -o solver_bench bench/solver_bench.cpp
+ */
+
+#include "../arena.h"
+#include "../simulator.h"
+#include "../solvers.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <sstream>
+
+/** Number of allocations made by the current thread */
+thread_local std::size_t allocations = 0;
+
+void* operator new(const std::size_t size) {
+    ++allocations;
+
+    if (auto* const memory = std::malloc(size ? size : 1))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+// Not inlined, otherwise GCC reports free() of the memory from the (replaced) operator new
+[[gnu::noinline]] void operator delete(void* const memory) noexcept { std::free(memory); }
+
+[[gnu::noinline]] void operator delete(void* const memory, std::size_t) noexcept { std::free(memory); }
+
+// Memory resources (std::pmr::new_delete_resource) allocate with the aligned operator new
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+    ++allocations;
+
+    const auto align = static_cast<std::size_t>(alignment);
+
+    if (auto* const memory = std::aligned_alloc(align, (std::max<std::size_t>(size, 1) + align - 1) / align * align))
+        return memory;
+
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* const memory, std::align_val_t) noexcept { std::free(memory); }
+
+[[gnu::noinline]] void operator delete(void* const memory, std::size_t, std::align_val_t) noexcept { std::free(memory); }
+
+/** @brief Table size of the corpus with the number of seeds */
+struct corpus_size {
+    int size;
+    int seeds;
+};
+
+/** Corpus: judge's table and larger generated ones, fewer seeds for larger tables */
+const std::array<corpus_size, 4> CORPUS = {{ { 9, 1000 }, { 16, 200 }, { 32, 50 }, { 64, 10 } }};
+
+/**
+ * Number of seeds of the table size with --quick: a tenth of the corpus, but at least 5,
+ * so every table size still has the worlds with the unreachable stone
+ */
+[[nodiscard]] int quick_seeds(const int corpus_seeds) { return std::max(corpus_seeds / 10, 5); }
+
+/** @brief Totals of the group of games */
+struct group_stats {
+    std::size_t maps = 0;
+    std::size_t accepted = 0;
+    std::size_t moves = 0;
+    std::size_t expansions = 0;
+    std::size_t allocations = 0;
+    std::chrono::nanoseconds wall_time {};
+    std::vector<std::chrono::nanoseconds> latencies;
+};
+
+/**
+ * Plays the game with the solver in-process and counts allocations of the solver
+ * @param solver Name of the solver
+ * @param world The world of the game
+ * @param arena Arena of the solve, released after it; the default resource is used if it is null
+ * @param buffers Buffers of the simulator's game with the move latencies
+ * @param solver_allocations Number of allocations made by the solver
+ */
+
+[[nodiscard]] run_result run_solver(
+        const std::string_view solver,
+        const game_world& world,
+        solve_arena* const arena,
+        game_buffers& buffers,
+        std::size_t& solver_allocations
+) {
+    auto* const resource = arena ? arena->resource() : std::pmr::get_default_resource();
+
+    return run_direct(world, buffers, [&](auto& io) {
+        const auto before = allocations;
+        play_solver(solver, world.size, io, resource);
+
+        if (arena)
+            arena->release();
+
+        solver_allocations = allocations - before;
+    });
+}
+
+/** Percentile of the sorted latencies in nanoseconds */
+[[nodiscard]] long long percentile(const std::vector<std::chrono::nanoseconds>& sorted, const double fraction) {
+    if (sorted.empty())
+        return 0;
+
+    const auto index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+    return sorted[index].count();
+}
+
+/** Writes the group of games as the JSON object */
+void write_group(
+        std::ostream& out,
+        const std::string_view solver,
+        const int size,
+        const int variant,
+        const bool reachable,
+        group_stats& stats
+) {
+    std::ranges::sort(stats.latencies);
+
+    const auto maps = static_cast<double>(stats.maps);
+    const auto wall_ms = std::chrono::duration<double, std::milli>(stats.wall_time).count();
+
+    out << "    {\"solver\": \"" << solver << "\", \"size\": " << size << ", \"variant\": " << variant
+        << ", \"reachable\": " << (reachable ? "true" : "false")
+        << ", \"maps\": " << stats.maps << ", \"accepted\": " << stats.accepted
+        << ", \"moves_per_solve\": " << static_cast<double>(stats.moves) / maps
+        << ", \"expansions_per_solve\": " << static_cast<double>(stats.expansions) / maps
+        << ", \"wall_ms_per_solve\": " << wall_ms / maps
+        << ", \"allocations_per_solve\": " << static_cast<double>(stats.allocations) / maps
+        << ", \"latency_p50_ns\": " << percentile(stats.latencies, 0.5)
+        << ", \"latency_p99_ns\": " << percentile(stats.latencies, 0.99) << "}";
+}
+
+int main(const int argc, const char* const argv[]) {
+    bool quick = false;
+    bool use_arena = true;
+    std::string output;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        if (arg == "--quick")
+            quick = true;
+        else if (arg == "--no-arena")
+            use_arena = false;
+        else if (arg == "--output" && i + 1 < argc)
+            output = argv[++i];
+    }
+
+    std::ostringstream json;
+    json << "{\n  \"corpus\": [";
+
+    for (std::size_t i = 0; i < CORPUS.size(); ++i)
+        json << (i ? ", " : "") << "{\"size\": " << CORPUS[i].size
+             << ", \"seeds\": " << (quick ? quick_seeds(CORPUS[i].seeds) : CORPUS[i].seeds) << "}";
+
+    json << "],\n  \"results\": [\n";
+    bool first_group = true;
+
+    for (const auto solver : SOLVERS) {
+        // Arena of the solver's games, it grows during the first games of every table size
+        solve_arena arena;
+        game_buffers buffers;
+
+        for (const auto& [size, corpus_seeds] : CORPUS) {
+            const int seeds = quick ? quick_seeds(corpus_seeds) : corpus_seeds;
+
+            // Groups by the perception variant and reachability of the stone
+            std::array<std::array<group_stats, 2>, 2> groups;
+
+            for (int seed = 0; seed < seeds; ++seed) {
+                for (int variant = 1; variant <= 2; ++variant) {
+                    std::mt19937 rng(seed);
+                    const auto world = generate_game_world(rng, size, variant);
+
+                    std::size_t solver_allocations = 0;
+                    const auto result = run_solver(solver, world, use_arena ? &arena : nullptr, buffers, solver_allocations);
+
+                    auto& stats = groups[variant - 1][world.shortest_path != -1];
+                    ++stats.maps;
+                    stats.accepted += result.outcome == verdict::accepted;
+                    stats.moves += result.moves;
+                    stats.expansions += result.cells_entered;
+                    stats.allocations += solver_allocations;
+                    stats.wall_time += result.wall_time;
+                    stats.latencies.insert(stats.latencies.end(), buffers.move_latencies.begin(), buffers.move_latencies.end());
+                }
+            }
+
+            for (int variant = 1; variant <= 2; ++variant) {
+                for (const bool reachable : { true, false }) {
+                    auto& stats = groups[variant - 1][reachable];
+                    if (!stats.maps) continue;
+
+                    json << (first_group ? "" : ",\n");
+                    write_group(json, solver, size, variant, reachable, stats);
+                    first_group = false;
+                }
+            }
+
+            std::cerr << solver << ' ' << size << 'x' << size << " done" << std::endl;
+        }
+    }
+
+    json << "\n  ]\n}\n";
+
+    if (output.empty()) {
+        std::cout << json.str();
+    } else {
+        std::ofstream file(output);
+        file << json.str();
+    }
+
+    return 0;
+}
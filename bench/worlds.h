@@ -0,0 +1,58 @@
+/**
+ * Randomly generated maps, shared by all benchmarks
+ */
+
+#pragma once
+
+#include "../grid.h"
+
+#include <random>
+#include <vector>
+
+/** Randomly generated map with the dangerous cells and the Infinity Stone */
+struct world {
+    int size;
+    std::vector<char> cells;
+    int inf_stone_n;
+    int inf_stone_m;
+};
+
+/**
+ * Generates maps with randomly placed dangerous cells
+ * @param amount Number of maps to generate
+ * @param seed Seed of the generator, so the same maps are generated for every engine
+ * @param size Size of the square maps
+ * @param danger_probability Probability of every cell to be dangerous
+ */
+
+[[nodiscard]] inline std::vector<world> generate_worlds(
+        const std::size_t amount,
+        const unsigned seed,
+        const int size = TABLE_SIZE,
+        const double danger_probability = 0.25
+) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> coordinate(0, size - 1);
+    std::bernoulli_distribution dangerous(danger_probability);
+
+    std::vector<world> worlds(amount);
+
+    for (auto& w : worlds) {
+        w.size = size;
+        w.cells.resize(static_cast<std::size_t>(size) * size);
+
+        for (auto& c : w.cells)
+            c = dangerous(rng) ? 'P' : 0;
+
+        // The stone is never placed at the initial cell
+        do {
+            w.inf_stone_n = coordinate(rng);
+            w.inf_stone_m = coordinate(rng);
+        } while (w.inf_stone_n == 0 && w.inf_stone_m == 0);
+
+        w.cells[0] = 'A';
+        w.cells[w.inf_stone_n * size + w.inf_stone_m] = 'I';
+    }
+
+    return worlds;
+}
@@ -0,0 +1,351 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <bitset>
+#include <cstdint>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "grid.h"
+
+/**
+ * @brief Set of cells of the fixed-size table, stored as a bit mask in row-major order
+ * (the judge's 9x9 table fits in 81 bits, i.e. two machine words).
+ * Membership test is a single AND, set operations work on whole words,
+ * neighbourhood of the whole set is built with shifts and column masks.
+ */
+
+template <typename extent> class bitboard {
+    static_assert(is_fixed_extent_v<extent>, "Bitboards are available only for the fixed-size tables");
+
+    static constexpr int WIDTH = extent::width();
+    static constexpr std::size_t CELLS = static_cast<std::size_t>(WIDTH) * extent::height();
+
+    using bits = std::bitset<CELLS>;
+
+    /** Creates the mask of all cells in the given column */
+    [[nodiscard]] static bits column(const int m) {
+        bits mask;
+
+        for (std::size_t c = m; c < CELLS; c += WIDTH)
+            mask.set(c);
+
+        return mask;
+    }
+
+    /** All cells, except the ones in the first column (may be shifted left) */
+    inline static const bits NOT_FIRST_COLUMN = ~column(0);
+
+    /** All cells, except the ones in the last column (may be shifted right) */
+    inline static const bits NOT_LAST_COLUMN = ~column(WIDTH - 1);
+
+    bits _bits;
+
+    explicit bitboard(const bits& b) : _bits(b) {}
+
+public:
+    explicit bitboard(const extent& = extent()) {}
+
+    /** Set with the single cell */
+    [[nodiscard]] static bitboard of(const cell_index c) {
+        bitboard board;
+        board.set(c);
+        return board;
+    }
+
+    [[nodiscard]] bool test(const cell_index c) const { return _bits.test(c); }
+
+    void set(const cell_index c) { _bits.set(c); }
+
+    void reset(const cell_index c) { _bits.reset(c); }
+
+    [[nodiscard]] bool any() const { return _bits.any(); }
+
+    [[nodiscard]] bool none() const { return _bits.none(); }
+
+    [[nodiscard]] std::size_t count() const { return _bits.count(); }
+
+    [[nodiscard]] bitboard operator&(const bitboard& other) const { return bitboard(_bits & other._bits); }
+
+    [[nodiscard]] bitboard operator|(const bitboard& other) const { return bitboard(_bits | other._bits); }
+
+    [[nodiscard]] bitboard operator~() const { return bitboard(~_bits); }
+
+    bitboard& operator&=(const bitboard& other) { _bits &= other._bits; return *this; }
+
+    bitboard& operator|=(const bitboard& other) { _bits |= other._bits; return *this; }
+
+    [[nodiscard]] bool operator==(const bitboard& other) const = default;
+
+    /**
+     * Replaces the current set with one step of the flood fill:
+     * all passable and not yet reached neighbours of the frontier
+     * @param frontier Cells reached during the last step
+     * @param passable Cells that may be reached
+     * @param reached Cells that were already reached
+     */
+
+    void expand_from(const bitboard& frontier, const bitboard& passable, const bitboard& reached) {
+        _bits = frontier.neighbours()._bits & passable._bits & ~reached._bits;
+    }
+
+    /**
+     * Constructs the set of all cells adjacent to any cell of the current set
+     * (up, down, left and right), without the current cells themselves unless
+     * they are adjacent to each other
+     */
+
+    [[nodiscard]] bitboard neighbours() const {
+        return bitboard(
+                (_bits >> WIDTH) |
+                (_bits << WIDTH) |
+                ((_bits & NOT_FIRST_COLUMN) >> 1) |
+                ((_bits & NOT_LAST_COLUMN) << 1)
+        );
+    }
+};
+
+/**
+ * @brief Set of cells of the runtime-sized table, stored as bit masks row by row.
+ * Every row occupies whole 64-bit words, so vertical shifts are moves of words
+ * and horizontal shifts never cross row boundaries. Interface matches the bitboard.
+ * Range of rows that may contain cells is tracked, so sparse sets
+ * (e.g. the frontier of the flood fill) are processed only where they are.
+ */
+
+class row_bitboard {
+    static constexpr int WORD_BITS = 64;
+
+    int _width;
+    int _height;
+
+    /** Number of words in every row */
+    std::size_t _row_words;
+
+    /** Valid bits of the last word in every row */
+    std::uint64_t _last_word_mask;
+
+    /** All rows outside of [_first_row, _last_row] are empty */
+    int _first_row;
+    int _last_row;
+
+    std::pmr::vector<std::uint64_t> _words;
+
+    [[nodiscard]] std::size_t word_of(const cell_index c) const {
+        const auto n = static_cast<std::size_t>(c / _width);
+        const auto m = static_cast<std::size_t>(c % _width);
+        return n * _row_words + m / WORD_BITS;
+    }
+
+    [[nodiscard]] std::uint64_t bit_of(const cell_index c) const {
+        return std::uint64_t(1) << (c % _width % WORD_BITS);
+    }
+
+    /** Words of the rows that may contain cells */
+    [[nodiscard]] std::span<const std::uint64_t> occupied_words() const {
+        if (_first_row > _last_row)
+            return {};
+
+        return std::span(_words).subspan(
+                _first_row * _row_words,
+                static_cast<std::size_t>(_last_row - _first_row + 1) * _row_words
+        );
+    }
+
+    /** Clears all words of the rows in [first, last] */
+    void clear_rows(const int first, const int last) {
+        if (first > last)
+            return;
+
+        std::fill(
+                _words.begin() + static_cast<std::ptrdiff_t>(first * _row_words),
+                _words.begin() + static_cast<std::ptrdiff_t>((last + 1) * _row_words),
+                0
+        );
+    }
+
+public:
+    template <typename extent> explicit row_bitboard(const extent& dimensions) :
+        _width(dimensions.width()),
+        _height(dimensions.height()),
+        _row_words((dimensions.width() + WORD_BITS - 1) / WORD_BITS),
+        _last_word_mask(~std::uint64_t(0) >> ((WORD_BITS - dimensions.width() % WORD_BITS) % WORD_BITS)),
+        _first_row(dimensions.height()),
+        _last_row(-1),
+        _words(_row_words * dimensions.height(), resource_of(dimensions)) {}
+
+    /** Copies keep the memory resource of the original set (pmr containers would select the default one) */
+    row_bitboard(const row_bitboard& other) :
+        _width(other._width),
+        _height(other._height),
+        _row_words(other._row_words),
+        _last_word_mask(other._last_word_mask),
+        _first_row(other._first_row),
+        _last_row(other._last_row),
+        _words(other._words, other._words.get_allocator()) {}
+
+    row_bitboard(row_bitboard&&) = default;
+
+    row_bitboard& operator=(const row_bitboard&) = default;
+
+    row_bitboard& operator=(row_bitboard&&) = default;
+
+    [[nodiscard]] bool test(const cell_index c) const { return _words[word_of(c)] & bit_of(c); }
+
+    void set(const cell_index c) {
+        const auto n = static_cast<int>(c / _width);
+        _first_row = std::min(_first_row, n);
+        _last_row = std::max(_last_row, n);
+        _words[word_of(c)] |= bit_of(c);
+    }
+
+    void reset(const cell_index c) { _words[word_of(c)] &= ~bit_of(c); }
+
+    [[nodiscard]] bool any() const {
+        for (const auto word : occupied_words())
+            if (word) return true;
+
+        return false;
+    }
+
+    [[nodiscard]] bool none() const { return !any(); }
+
+    [[nodiscard]] std::size_t count() const {
+        std::size_t result = 0;
+
+        for (const auto word : occupied_words())
+            result += std::popcount(word);
+
+        return result;
+    }
+
+    row_bitboard& operator&=(const row_bitboard& other) {
+        for (std::size_t i = 0; i < _words.size(); ++i)
+            _words[i] &= other._words[i];
+
+        _first_row = std::max(_first_row, other._first_row);
+        _last_row = std::min(_last_row, other._last_row);
+        return *this;
+    }
+
+    row_bitboard& operator|=(const row_bitboard& other) {
+        if (other._first_row > other._last_row)
+            return *this;
+
+        const auto begin = other._first_row * _row_words;
+        const auto end = (other._last_row + 1) * _row_words;
+
+        for (std::size_t i = begin; i < end; ++i)
+            _words[i] |= other._words[i];
+
+        _first_row = std::min(_first_row, other._first_row);
+        _last_row = std::max(_last_row, other._last_row);
+        return *this;
+    }
+
+    [[nodiscard]] row_bitboard operator&(const row_bitboard& other) const { return row_bitboard(*this) &= other; }
+
+    [[nodiscard]] row_bitboard operator|(const row_bitboard& other) const { return row_bitboard(*this) |= other; }
+
+    [[nodiscard]] row_bitboard operator~() const {
+        auto result = *this;
+
+        for (std::size_t i = 0; i < _words.size(); ++i)
+            result._words[i] = ~_words[i] & ((i + 1) % _row_words ? ~std::uint64_t(0) : _last_word_mask);
+
+        result._first_row = 0;
+        result._last_row = _height - 1;
+        return result;
+    }
+
+    [[nodiscard]] bool operator==(const row_bitboard& other) const { return _words == other._words; }
+
+    /**
+     * Replaces the current set with one step of the flood fill:
+     * all passable and not yet reached neighbours of the frontier.
+     * Storage of the current set is reused, so no allocations happen,
+     * only rows adjacent to the frontier's rows are processed
+     * @param frontier Cells reached during the last step
+     * @param passable Cells that may be reached
+     * @param reached Cells that were already reached
+     */
+
+    void expand_from(const row_bitboard& frontier, const row_bitboard& passable, const row_bitboard& reached) {
+        const auto& f = frontier._words;
+        const int first = std::max(frontier._first_row - 1, 0);
+        const int last = std::min(frontier._last_row + 1, _height - 1);
+
+        // Rows of the previous set that will not be overwritten
+        clear_rows(_first_row, std::min(_last_row, first - 1));
+        clear_rows(std::max(_first_row, last + 1), _last_row);
+
+        _first_row = _height;
+        _last_row = -1;
+
+        for (int row = first; row <= last; ++row) {
+            const auto begin = row * _row_words;
+            std::uint64_t row_bits = 0;
+
+            for (std::size_t i = begin; i < begin + _row_words; ++i) {
+                // Cells above and below
+                const auto up = row > 0 ? f[i - _row_words] : 0;
+                const auto down = row + 1 < _height ? f[i + _row_words] : 0;
+
+                // Cells to the right and to the left, carrying bits between words of the same row
+                const auto right = (f[i] << 1) | (i > begin ? f[i - 1] >> (WORD_BITS - 1) : 0);
+                const auto left = (f[i] >> 1) | (i + 1 < begin + _row_words ? f[i + 1] << (WORD_BITS - 1) : 0);
+
+                // Passable cells never contain bits beyond the row's width
+                _words[i] = (up | down | left | right) & passable._words[i] & ~reached._words[i];
+                row_bits |= _words[i];
+            }
+
+            if (row_bits) {
+                _first_row = std::min(_first_row, row);
+                _last_row = row;
+            }
+        }
+    }
+};
+
+/** Set of cells: bitboard for the fixed-size tables, row-wise bitboard for the runtime-sized ones */
+template <typename extent> using cell_set = std::conditional_t<is_fixed_extent_v<extent>, bitboard<extent>, row_bitboard>;
+
+/**
+ * @brief Bit-parallel breadth-first search over the passable cells.
+ * The whole frontier is expanded at once: it is shifted in four directions
+ * and intersected with the passable cells that were not reached before.
+ * Every distance layer is emitted to the callback, so the distance to any cell
+ * is the number of layers before the one containing it.
+ *
+ * @param start Cells to start from (distance 0)
+ * @param passable Cells that may be reached
+ * @param on_layer Callback with the distance and the set of cells on this distance,
+ * returns true to stop the search
+ * @return distance of the layer where the search was stopped, -1 if all reachable cells were emitted
+ */
+
+template <typename board, typename callback> int layered_flood_fill(
+        const board& start,
+        const board& passable,
+        callback&& on_layer
+) {
+    auto frontier = start;
+    auto reached = start;
+    auto next = start;
+
+    for (int distance = 0; frontier.any(); ++distance) {
+        if (on_layer(distance, static_cast<const board&>(frontier)))
+            return distance;
+
+        next.expand_from(frontier, passable, reached);
+        reached |= next;
+        std::swap(frontier, next);
+    }
+
+    return -1;
+}
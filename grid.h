@@ -0,0 +1,348 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <memory_resource>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+const int INF = INT32_MAX / 2;
+
+/** Size of the judge's game table */
+const int TABLE_SIZE = 9;
+
+/** Index of the cell in the flat game table (n * width + m) */
+using cell_index = std::uint32_t;
+
+/** Sentinel index for the absent cell (e.g. parent of the initial cell) */
+const cell_index NO_CELL = UINT32_MAX;
+
+/**
+ * @brief Dimensions of the game table, known at compile time.
+ * Bounds checks and neighbour offsets are constants for such tables.
+ */
+
+template <int Width, int Height = Width> struct fixed_extent {
+    static_assert(Width > 0 && Height > 0, "Table must have at least one cell");
+
+    [[nodiscard]] static constexpr int width() { return Width; }
+
+    [[nodiscard]] static constexpr int height() { return Height; }
+};
+
+/** Checks whether the table's dimensions are known at compile time */
+template <typename extent> struct is_fixed_extent : std::false_type {};
+
+template <int Width, int Height> struct is_fixed_extent<fixed_extent<Width, Height>> : std::true_type {};
+
+template <typename extent> constexpr bool is_fixed_extent_v = is_fixed_extent<extent>::value;
+
+/** @brief Dimensions of the game table, known only at runtime (e.g. large generated maps) */
+
+class dynamic_extent {
+    int _width;
+    int _height;
+
+public:
+    dynamic_extent(const int width, const int height) : _width(width), _height(height) {}
+
+    [[nodiscard]] int width() const { return _width; }
+
+    [[nodiscard]] int height() const { return _height; }
+};
+
+/**
+ * @brief Calculates the Manhattan distance between two cells on the game table
+ * @param from_n The row coordinate of the starting cell
+ * @param from_m The column coordinate of the starting cell
+ * @param to_n The row coordinate of the destination cell
+ * @param to_m The column coordinate of the destination cell
+ * @return The Manhattan distance between the two cells
+ */
+
+[[nodiscard]] constexpr int manhattan_distance(
+        const int from_n,
+        const int from_m,
+        const int to_n,
+        const int to_m
+) {
+    const int delta_n = from_n > to_n ? from_n - to_n : to_n - from_n;
+    const int delta_m = from_m > to_m ? from_m - to_m : to_m - from_m;
+    return delta_n + delta_m;
+}
+
+/**
+ * Checks whether the cell's status is dangerous to move
+ * @return true if the status is dangerous, false otherwise.
+ */
+
+[[nodiscard]] inline bool dangerous_status(const char cell_status) {
+    return cell_status == 'P' || cell_status == 'M' || cell_status == 'H' || cell_status == 'T';
+}
+
+/** Offsets (n, m) of cells perceived by Thanos in the first variant (Moore neighbourhood) */
+constexpr std::array<std::pair<int, int>, 8> FIRST_PERCEPTION = {{
+        { -1, -1 }, { -1, 0 }, { -1, 1 },
+        { 0, -1 }, { 0, 1 },
+        { 1, -1 }, { 1, 0 }, { 1, 1 }
+}};
+
+/** Offsets (n, m) of cells perceived by Thanos in the second variant (Moore neighbourhood with ears) */
+constexpr std::array<std::pair<int, int>, 12> SECOND_PERCEPTION = {{
+        { -2, 0 },
+        { -1, -1 }, { -1, 0 }, { -1, 1 },
+        { 0, -2 }, { 0, -1 }, { 0, 1 }, { 0, 2 },
+        { 1, -1 }, { 1, 0 }, { 1, 1 },
+        { 2, 0 }
+}};
+
+/** Offsets (n, m) of cells in the Hulk's zone (von Neumann neighbourhood) */
+constexpr std::array<std::pair<int, int>, 4> HULK_ZONE = {{ { -1, 0 }, { 0, -1 }, { 0, 1 }, { 1, 0 } }};
+
+/** Offsets (n, m) of cells in the Thor's zone (Moore neighbourhood, the same as the first Thanos perception) */
+constexpr const auto& THOR_ZONE = FIRST_PERCEPTION;
+
+/** Offsets (n, m) of cells in the Captain Marvel's zone (Moore neighbourhood with ears) */
+constexpr const auto& CAPTAIN_MARVEL_ZONE = SECOND_PERCEPTION;
+
+/**
+ * @brief Thanos perception variant, known at compile time,
+ * so the perception loops are specialized (and unrolled) for every variant
+ * @tparam Variant 1 for the Moore neighbourhood, 2 for the Moore neighbourhood with ears
+ */
+
+template <int Variant> struct thanos_perception;
+
+template <> struct thanos_perception<1> {
+    static constexpr int VARIANT = 1;
+
+    /** Offsets (n, m) of the perceived cells */
+    static constexpr const auto& OFFSETS = FIRST_PERCEPTION;
+};
+
+template <> struct thanos_perception<2> {
+    static constexpr int VARIANT = 2;
+
+    /** Offsets (n, m) of the perceived cells */
+    static constexpr const auto& OFFSETS = SECOND_PERCEPTION;
+};
+
+/**
+ * Dispatches the game's Thanos perception variant to the code specialized for it
+ * @param variant Thanos perception variant from the judge: 2 for the extended one, Moore neighbourhood otherwise
+ * @param f Function called with thanos_perception<1> or thanos_perception<2>
+ * @return The result of the function
+ */
+
+template <typename F> decltype(auto) with_thanos_perception(const int variant, F&& f) {
+    if (variant == 2)
+        return f(thanos_perception<2>());
+
+    return f(thanos_perception<1>());
+}
+
+/** @brief Fixed-capacity list of neighbouring cells, generated without allocations */
+
+class neighbour_list {
+    std::array<cell_index, 4> _cells {};
+    std::size_t _size = 0;
+
+public:
+    constexpr void push_back(const cell_index c) { _cells[_size++] = c; }
+
+    [[nodiscard]] constexpr std::size_t size() const { return _size; }
+
+    [[nodiscard]] constexpr cell_index operator[](const std::size_t i) const { return _cells[i]; }
+
+    [[nodiscard]] constexpr auto begin() const { return _cells.begin(); }
+
+    [[nodiscard]] constexpr auto end() const { return _cells.begin() + static_cast<std::ptrdiff_t>(_size); }
+};
+
+/**
+ * Generates all neighbouring cells inside the table's borders.
+ * Neighbours are listed in the ascending order of indices: up, left, right, down.
+ * @param c Cell whose neighbours are generated
+ * @param width Number of columns in the table
+ * @param height Number of rows in the table
+ */
+
+[[nodiscard]] constexpr neighbour_list generate_neighbours(const cell_index c, const int width, const int height) {
+    const int cn = static_cast<int>(c) / width;
+    const int cm = static_cast<int>(c) % width;
+    const auto row = static_cast<cell_index>(width);
+
+    neighbour_list next;
+
+    if (cn > 0) next.push_back(c - row);
+    if (cm > 0) next.push_back(c - 1);
+    if (cm + 1 < width) next.push_back(c + 1);
+    if (cn + 1 < height) next.push_back(c + row);
+
+    return next;
+}
+
+/** Maximum number of cells in the fixed-size table whose distances are precomputed (quadratic in cells) */
+constexpr int MAX_DISTANCE_TABLE_CELLS = 256;
+
+/**
+ * @brief Lookup tables of the fixed-size game table, generated at compile time:
+ * neighbour lists of all cells (cells outside of borders are already removed)
+ * and Manhattan distances between all pairs of cells (only for small tables)
+ */
+
+template <int Width, int Height> struct fixed_tables {
+    static constexpr int CELLS = Width * Height;
+
+    /** Distances are precomputed for the judge's table, large tables compute them */
+    static constexpr bool HAS_DISTANCES = CELLS <= MAX_DISTANCE_TABLE_CELLS;
+
+    /** Neighbour lists of all cells */
+    static constexpr auto NEIGHBOURS = [] {
+        std::array<neighbour_list, CELLS> neighbours {};
+
+        for (int c = 0; c < CELLS; ++c)
+            neighbours[c] = generate_neighbours(static_cast<cell_index>(c), Width, Height);
+
+        return neighbours;
+    }();
+
+    /** Distance between cells first and second is DISTANCES[first * CELLS + second] */
+    static constexpr auto DISTANCES = [] {
+        std::array<std::uint8_t, HAS_DISTANCES ? CELLS * CELLS : 0> distances {};
+
+        if constexpr (HAS_DISTANCES) {
+            for (int first = 0; first < CELLS; ++first)
+                for (int second = 0; second < CELLS; ++second)
+                    distances[first * CELLS + second] = static_cast<std::uint8_t>(manhattan_distance(
+                            first / Width, first % Width, second / Width, second % Width
+                    ));
+        }
+
+        return distances;
+    }();
+};
+
+/**
+ * Memory resource for the storage built from the game table: its own resource for grids,
+ * the default one for plain dimensions
+ * @param dimensions The game table or its dimensions
+ */
+
+template <typename extent> [[nodiscard]] std::pmr::memory_resource* resource_of(const extent& dimensions) {
+    if constexpr (requires { dimensions.resource(); })
+        return dimensions.resource();
+    else
+        return std::pmr::get_default_resource();
+}
+
+/**
+ * @brief Simulation table, stored as one array of cells in row-major order.
+ * Cell with coordinates (n, m) is addressed by n * width + m.
+ * All coordinate arithmetic, bounds checks and neighbour generation
+ * are shared by all solvers and all table dimensions.
+ * Cells are allocated from the memory resource of the table, all other storage of the solve
+ * (open lists, sets of cells, routers, paths) is allocated from the same resource.
+ *
+ * @tparam cell Plain record of the cell, specific to the solver
+ * @tparam extent Dimensions of the table: fixed_extent or dynamic_extent
+ */
+
+template <typename cell, typename extent> class grid : public extent {
+    /** All cells of the table */
+    std::pmr::vector<cell> _cells;
+
+public:
+    /**
+     * Constructs the table of default cells
+     * @param dimensions Dimensions of the table
+     * @param resource Memory resource for the cells and the rest of the solve's storage
+     */
+
+    explicit grid(
+            const extent& dimensions = extent(),
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+    ) :
+        extent(dimensions),
+        _cells(static_cast<std::size_t>(dimensions.width()) * dimensions.height(), resource) {}
+
+    /** Memory resource of the table, shared by all storage of the solve */
+    [[nodiscard]] std::pmr::memory_resource* resource() const { return _cells.get_allocator().resource(); }
+
+    /** Index of the cell with the given row and column coordinates */
+    [[nodiscard]] cell_index index(const int n, const int m) const {
+        return static_cast<cell_index>(n * this->width() + m);
+    }
+
+    /** The row coordinate of the cell */
+    [[nodiscard]] int n(const cell_index c) const { return static_cast<int>(c) / this->width(); }
+
+    /** The column coordinate of the cell */
+    [[nodiscard]] int m(const cell_index c) const { return static_cast<int>(c) % this->width(); }
+
+    /** Total number of cells in the table */
+    [[nodiscard]] std::size_t size() const { return _cells.size(); }
+
+    /** All cells of the table in row-major order */
+    [[nodiscard]] std::span<const cell> cells() const { return _cells; }
+
+    [[nodiscard]] cell& operator[](const cell_index c) { return _cells[c]; }
+
+    [[nodiscard]] const cell& operator[](const cell_index c) const { return _cells[c]; }
+
+    /**
+     * Checks whether the coordinates are in game table's borders
+     * @param n cell's row coordinate
+     * @param m cell's column coordinate
+     */
+
+    [[nodiscard]] bool in_borders(const int n, const int m) const {
+        return n >= 0 && n < this->height() && m >= 0 && m < this->width();
+    }
+
+    /**
+     * Checks whether both cells are neighbours (or the same cell)
+     * @param first First cell to check
+     * @param second Second cell to check
+     * @return true if both cells are neighbours, false otherwise
+     */
+
+    [[nodiscard]] bool neighbour(const cell_index first, const cell_index second) const {
+        return distance(first, second) < 2;
+    }
+
+    /**
+     * Lists all neighbouring cells inside the table's borders.
+     * Neighbours are listed in the ascending order of indices: up, left, right, down.
+     * Fixed-size tables look up the list generated at compile time, others generate it
+     * @param c Cell whose neighbours are listed
+     */
+
+    [[nodiscard]] neighbour_list neighbours(const cell_index c) const {
+        if constexpr (is_fixed_extent_v<extent>)
+            return fixed_tables<extent::width(), extent::height()>::NEIGHBOURS[c];
+        else
+            return generate_neighbours(c, this->width(), this->height());
+    }
+
+    /**
+     * Manhattan distance between two cells.
+     * Small fixed-size tables look up the distance precomputed at compile time
+     * @param first First cell
+     * @param second Second cell
+     */
+
+    [[nodiscard]] int distance(const cell_index first, const cell_index second) const {
+        if constexpr (is_fixed_extent_v<extent>) {
+            using tables = fixed_tables<extent::width(), extent::height()>;
+
+            if constexpr (tables::HAS_DISTANCES)
+                return tables::DISTANCES[first * tables::CELLS + second];
+        }
+
+        return manhattan_distance(n(first), m(first), n(second), m(second));
+    }
+};
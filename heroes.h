@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <utility>
+
+#include "grid.h"
+
+/**
+ * Heroes of the game as bit masks, with the heroes behind the perceived statuses
+ * and the perception zone of every hero (used by the simulator to tell whose zones cover the cells)
+ */
+
+/** Mask of heroes, one bit per hero */
+using hero_mask = std::uint8_t;
+
+constexpr hero_mask HULK = 1 << 0;
+constexpr hero_mask CAPTAIN_MARVEL = 1 << 1;
+constexpr hero_mask THOR = 1 << 2;
+constexpr hero_mask ALL_HEROES = HULK | CAPTAIN_MARVEL | THOR;
+
+/**
+ * Heroes who may make the cell with the perceived status dangerous
+ * @param status Perceived status of the cell
+ * @return the hero for its own cell, all heroes for the perception zone, no heroes otherwise
+ */
+
+[[nodiscard]] constexpr hero_mask heroes_of_status(const char status) {
+    switch (status) {
+        case 'H': return HULK;
+        case 'M': return CAPTAIN_MARVEL;
+        case 'T': return THOR;
+        case 'P': return ALL_HEROES;
+        default: return 0;
+    }
+}
+
+/** Offsets (n, m) of cells in the zone of the single hero */
+[[nodiscard]] constexpr std::span<const std::pair<int, int>> zone_of(const hero_mask hero) {
+    if (hero == HULK)
+        return HULK_ZONE;
+
+    if (hero == THOR)
+        return THOR_ZONE;
+
+    return CAPTAIN_MARVEL_ZONE;
+}
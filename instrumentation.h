@@ -0,0 +1,205 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <vector>
+
+/**
+ * Instrumentation of the solvers: counters of the search and timers of the moves.
+ * Disabled by default, every hook is an empty inline function then, so it adds no code.
+ * Build with -DSOLVER_INSTRUMENTATION to enable it; the summary is written at exit
+ * to stderr or appended to the file given by the SOLVER_STATS environment variable.
+ * Moves of stdio_transport are timed with steady_clock (vDSO, no system calls): decision time
+ * is measured from the last response (or the previous move) to the move, I/O wait from the move
+ * to its parsed response. Statistics are collected per thread and merged at its exit,
+ * so in-process games in parallel threads are counted without synchronisation.
+ */
+
+namespace instrumentation {
+
+#ifdef SOLVER_INSTRUMENTATION
+constexpr bool ENABLED = true;
+#else
+constexpr bool ENABLED = false;
+#endif
+
+using clock = std::chrono::steady_clock;
+
+/** @brief Counters and timings of the solvers */
+struct stats {
+    /** Cells expanded by the searches (A* and LPA* expansions, cells entered by the depth-first search) */
+    std::size_t expansions = 0;
+
+    /** The largest size of the open list (stack of the depth-first search) */
+    std::size_t open_high_water = 0;
+
+    /** The largest size of the closed set (visited cells of the depth-first search) */
+    std::size_t closed_high_water = 0;
+
+    /** Moves without the response analysis (routes through the known cells, returns) */
+    std::size_t blind_moves = 0;
+
+    /** Decision time of every move in nanoseconds */
+    std::vector<std::int64_t> decision_ns;
+
+    /** Time from every move to its parsed response in nanoseconds, only for the read responses */
+    std::vector<std::int64_t> io_wait_ns;
+
+    void merge(const stats& other) {
+        expansions += other.expansions;
+        open_high_water = std::max(open_high_water, other.open_high_water);
+        closed_high_water = std::max(closed_high_water, other.closed_high_water);
+        blind_moves += other.blind_moves;
+        decision_ns.insert(decision_ns.end(), other.decision_ns.begin(), other.decision_ns.end());
+        io_wait_ns.insert(io_wait_ns.end(), other.io_wait_ns.begin(), other.io_wait_ns.end());
+    }
+};
+
+/** Writes mean, median, 99th percentile and maximum of the times in microseconds */
+inline void write_times(std::ostream& out, const char* name, std::vector<std::int64_t> times) {
+    out << name << ": ";
+
+    if (times.empty()) {
+        out << "no samples" << std::endl;
+        return;
+    }
+
+    std::ranges::sort(times);
+
+    std::int64_t total = 0;
+    for (const auto time : times) total += time;
+
+    auto microseconds = [](const double ns) { return ns / 1000; };
+    const auto percentile = [&](const double fraction) {
+        return microseconds(static_cast<double>(times[static_cast<std::size_t>(fraction * static_cast<double>(times.size() - 1))]));
+    };
+
+    out << "mean " << microseconds(static_cast<double>(total) / static_cast<double>(times.size())) << " us, "
+        << "p50 " << percentile(0.5) << " us, p99 " << percentile(0.99) << " us, "
+        << "max " << microseconds(static_cast<double>(times.back())) << " us" << std::endl;
+}
+
+/** @brief Statistics of the whole process, written at exit */
+class summary {
+    std::mutex _mutex;
+    stats _total;
+
+public:
+    void merge(const stats& thread_stats) {
+        const std::lock_guard lock(_mutex);
+        _total.merge(thread_stats);
+    }
+
+    ~summary() {
+        std::ofstream file;
+        std::ostream* out = &std::cerr;
+
+        if (const char* path = std::getenv("SOLVER_STATS")) {
+            file.open(path, std::ios::app);
+            out = &file;
+        }
+
+        *out << "instrumentation summary" << std::endl
+             << "moves: " << _total.decision_ns.size() << " (blind " << _total.blind_moves << ")" << std::endl
+             << "expansions: " << _total.expansions << std::endl
+             << "open high-water: " << _total.open_high_water << std::endl
+             << "closed high-water: " << _total.closed_high_water << std::endl;
+
+        write_times(*out, "decision time per move", std::move(_total.decision_ns));
+        write_times(*out, "io wait per move", std::move(_total.io_wait_ns));
+    }
+};
+
+[[nodiscard]] inline summary& process_summary() {
+    static summary instance;
+    return instance;
+}
+
+/** @brief Statistics of the thread, merged into the summary at the thread's exit */
+struct thread_stats {
+    stats current;
+
+    /** The last moment the player was ready to decide: the last response or move */
+    clock::time_point ready = clock::now();
+
+    /** Moment the last move was sent */
+    clock::time_point sent = ready;
+
+    ~thread_stats() { process_summary().merge(current); }
+};
+
+[[nodiscard]] inline thread_stats& this_thread() {
+    // Summary is created before any thread statistics, so it is destroyed after them
+    [[maybe_unused]] static auto& summary = process_summary();
+
+    thread_local thread_stats instance;
+    return instance;
+}
+
+[[nodiscard]] inline std::int64_t nanoseconds(const clock::duration time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time).count();
+}
+
+/** Counts the cell expanded by the search */
+inline void count_expansion() {
+    if constexpr (ENABLED)
+        ++this_thread().current.expansions;
+}
+
+/** Observes the size of the open list (stack of the depth-first search) */
+inline void observe_open_size(const std::size_t size) {
+    if constexpr (ENABLED) {
+        auto& high_water = this_thread().current.open_high_water;
+        high_water = std::max(high_water, size);
+    }
+}
+
+/** Observes the size of the closed set, counted only if the instrumentation is enabled */
+template <typename cell_set> void observe_closed_set(const cell_set& closed) {
+    if constexpr (ENABLED) {
+        auto& high_water = this_thread().current.closed_high_water;
+        high_water = std::max(high_water, static_cast<std::size_t>(closed.count()));
+    }
+}
+
+/** Counts the move without the response analysis */
+inline void count_blind_move() {
+    if constexpr (ENABLED)
+        ++this_thread().current.blind_moves;
+}
+
+/** Marks the start of the game: the initial input is read */
+inline void game_started() {
+    if constexpr (ENABLED)
+        this_thread().ready = clock::now();
+}
+
+/** Marks the move: its decision time is the time since the player was ready */
+inline void move_sent() {
+    if constexpr (ENABLED) {
+        auto& thread = this_thread();
+        const auto now = clock::now();
+
+        thread.current.decision_ns.push_back(nanoseconds(now - thread.ready));
+        thread.ready = thread.sent = now;
+    }
+}
+
+/** Marks the parsed response to the last move: its I/O wait is the time since the move */
+inline void response_received() {
+    if constexpr (ENABLED) {
+        auto& thread = this_thread();
+        const auto now = clock::now();
+
+        thread.current.io_wait_ns.push_back(nanoseconds(now - thread.sent));
+        thread.ready = now;
+    }
+}
+
+} // namespace instrumentation
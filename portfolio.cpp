@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <iostream>
+#include <latch>
+#include <map>
+#include <mutex>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "simulator.h"
+#include "solvers.h"
+
+/** Index of the racer when nobody has won the race */
+constexpr std::size_t NO_WINNER = SIZE_MAX;
+
+/**
+ * @brief Transport of the single racer: the game with the simulator through direct_transport
+ * that may be cancelled by the race. The racer is cancelled once the race is decided
+ * or once it made as many moves as the best accepted rival, so it can no longer win.
+ * After the cancellation moves are not played and the answer is ignored,
+ * the verdict of the game is cancelled.
+ */
+
+class racing_transport {
+    direct_transport _io;
+    run_result& _result;
+    std::stop_token _stop;
+
+    /** Moves of the best accepted rival */
+    const std::atomic<std::size_t>& _bound;
+
+    bool _is_cancelled = false;
+
+    /** Cancels the game once the race requested it, returns whether the game is cancelled */
+    bool check_cancelled() {
+        if (!_is_cancelled && stop_requested()) {
+            _is_cancelled = true;
+            _result.outcome = verdict::cancelled;
+        }
+
+        return _is_cancelled;
+    }
+
+public:
+    /**
+     * @param world The world of the game
+     * @param result Statistics of the game to fill
+     * @param buffers Buffers of the simulator's game, reused by the racer's following games
+     * @param stop Token of the racer's thread, requested once the race is decided
+     * @param bound Moves of the best accepted rival, SIZE_MAX if there is none yet
+     */
+
+    racing_transport(
+            const game_world& world,
+            run_result& result,
+            game_buffers& buffers,
+            std::stop_token stop,
+            const std::atomic<std::size_t>& bound
+    ) :
+        _io(world, result, buffers, max_moves(world)),
+        _result(result),
+        _stop(std::move(stop)),
+        _bound(bound) {}
+
+    [[nodiscard]] game_start start() { return _io.start(); }
+
+    void blind_move(const int x, const int y) { move(x, y); }
+
+    void move(const int x, const int y) {
+        if (!check_cancelled())
+            _io.move(x, y);
+    }
+
+    [[nodiscard]] std::span<const perceived_cell> response() const {
+        return _is_cancelled ? std::span<const perceived_cell>() : _io.response();
+    }
+
+    /** The answer of the solver that gave up after the cancellation is ignored */
+    void end(const int cost) {
+        if (!check_cancelled())
+            _io.end(cost);
+    }
+
+    [[nodiscard]] bool stop_requested() const {
+        return _is_cancelled || _stop.stop_requested() || _result.moves >= _bound.load(std::memory_order_relaxed);
+    }
+};
+
+/** @brief Decision of the race */
+enum class race_policy {
+    /** The first racer that finished with the accepted answer wins, the others are cancelled */
+    first_finish,
+
+    /**
+     * The accepted racer with the fewest moves within the time budget wins (the earlier one on ties).
+     * Racers are cancelled once they cannot win or the budget is over
+     */
+    fewest_moves
+};
+
+/** @brief Result of the race on the single world */
+struct race_result {
+    /** Statistics of every racer's game, wall_time is the time of the racer */
+    std::vector<run_result> results;
+
+    /** Index of the winner, NO_WINNER if no racer was accepted */
+    std::size_t winner = NO_WINNER;
+};
+
+/**
+ * Races the solvers on the same world, every solver plays with its own simulator in its own thread
+ * @param world The world of the game
+ * @param racers Names of the solvers
+ * @param policy Decision of the race
+ * @param budget Time budget of the race for the fewest_moves policy
+ * @param buffers Buffers of the simulator's games, one per racer, reused by the following races
+ * @return statistics of the racers and the winner
+ */
+
+[[nodiscard]] race_result race(
+        const game_world& world,
+        const std::span<const std::string_view> racers,
+        const race_policy policy,
+        const std::chrono::nanoseconds budget,
+        const std::span<game_buffers> buffers
+) {
+    using clock = std::chrono::steady_clock;
+
+    race_result race;
+    race.results.resize(racers.size());
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t finished = 0;
+    std::atomic<std::size_t> bound = SIZE_MAX;
+
+    // Racers and the coordinator start together, so thread creation is not counted
+    std::latch ready(static_cast<std::ptrdiff_t>(racers.size() + 1));
+    std::vector<std::jthread> threads;
+    threads.reserve(racers.size());
+
+    for (std::size_t i = 0; i < racers.size(); ++i) {
+        threads.emplace_back([&, i](std::stop_token stop) {
+            auto& result = race.results[i];
+            racing_transport io(world, result, buffers[i], std::move(stop), bound);
+
+            ready.arrive_and_wait();
+            const auto start = clock::now();
+            play_solver(racers[i], world.size, io);
+            result.wall_time = clock::now() - start;
+
+            {
+                const std::lock_guard lock(mutex);
+                ++finished;
+
+                if (result.outcome == verdict::accepted) {
+                    if (policy == race_policy::first_finish && race.winner == NO_WINNER)
+                        race.winner = i;
+
+                    if (policy == race_policy::fewest_moves)
+                        bound.store(std::min(bound.load(std::memory_order_relaxed), result.moves), std::memory_order_relaxed);
+                }
+            }
+
+            done.notify_all();
+        });
+    }
+
+    ready.arrive_and_wait();
+    const auto deadline = clock::now() + budget;
+
+    {
+        std::unique_lock lock(mutex);
+
+        if (policy == race_policy::first_finish)
+            done.wait(lock, [&] { return finished == racers.size() || race.winner != NO_WINNER; });
+        else
+            done.wait_until(lock, deadline, [&] { return finished == racers.size(); });
+    }
+
+    // Cancelling the remaining racers and waiting for them
+    for (auto& thread : threads)
+        thread.request_stop();
+
+    threads.clear();
+
+    if (policy == race_policy::fewest_moves) {
+        for (std::size_t i = 0; i < racers.size(); ++i) {
+            const auto& result = race.results[i];
+
+            if (result.outcome != verdict::accepted)
+                continue;
+
+            if (race.winner == NO_WINNER || result.moves < race.results[race.winner].moves
+                    || (result.moves == race.results[race.winner].moves && result.wall_time < race.results[race.winner].wall_time))
+                race.winner = i;
+        }
+    }
+
+    return race;
+}
+
+/**
+ * Class of the map for the selection of the solver: size of the table, Thanos perception variant
+ * and the shape of the shortest path: open (as long as the Manhattan distance to the stone),
+ * detour (around the dangerous cells) or unreachable
+ * @param world The world of the game
+ */
+
+[[nodiscard]] std::string map_class(const game_world& world) {
+    const auto shape = world.shortest_path < 0 ? "unreachable"
+            : world.shortest_path == world.inf_stone_n + world.inf_stone_m ? "open" : "detour";
+
+    return std::to_string(world.size) + 'x' + std::to_string(world.size)
+            + " v" + std::to_string(world.thanos_variant) + ' ' + shape;
+}
+
+/**
+ * Usage: portfolio [--solver NAME,NAME[,NAME...]] [--budget MS] [world-file...]
+ * Solvers: astar, astar-incremental, backtracking, backtracking-goal or all (astar,backtracking by default).
+ *
+ * Loads the world descriptions (written with simulator --dump) from the files or from stdin
+ * and races the solvers on every world, every solver in its own thread with its own simulator.
+ * By default the first solver that finished with the accepted answer wins and the others are cancelled;
+ * with --budget the accepted solver with the fewest moves within the budget wins, and solvers are cancelled
+ * once they made as many moves as the best finished rival or the budget is over.
+ * One result line per world is printed, the win rates of the solvers per map class are printed to stderr, e.g.
+ * simulator --seeds 1000 --dump > worlds.txt && portfolio --budget 100 worlds.txt
+ * Verdicts other than accepted are only reported in the result lines,
+ * the exit code is 1 only for the errors of the tool: unknown solver, unreadable or invalid world files.
+ *
+ * Build: g++ -std=c++20 -O2 -pthread -o portfolio portfolio.cpp
+ */
+
+int main(const int argc, const char* const argv[]) {
+    std::vector<std::string_view> racers;
+    auto policy = race_policy::first_finish;
+    std::chrono::nanoseconds budget {};
+    std::vector<std::string> files;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        if (arg == "--solver" && i + 1 < argc) {
+            if (!add_solvers(argv[++i], racers, "portfolio"))
+                return 1;
+        } else if (arg == "--budget" && i + 1 < argc) {
+            policy = race_policy::fewest_moves;
+            budget = std::chrono::milliseconds(std::max(std::atoi(argv[++i]), 0));
+        } else {
+            files.emplace_back(arg);
+        }
+    }
+
+    if (racers.empty())
+        racers = { "astar", "backtracking" };
+
+    std::vector<game_world> worlds;
+
+    if (!load_game_worlds(files, worlds, "portfolio"))
+        return 1;
+
+    auto milliseconds = [](const std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    };
+
+    // Wins of every racer per map class, the last one counts the races without the winner
+    std::map<std::string, std::vector<std::size_t>> wins;
+    std::vector<game_buffers> buffers(racers.size());
+
+    for (std::size_t w = 0; w < worlds.size(); ++w) {
+        const auto& world = worlds[w];
+        const auto name = map_class(world);
+        const auto result = race(world, racers, policy, budget, buffers);
+
+        auto& class_wins = wins[name];
+        class_wins.resize(racers.size() + 1);
+        ++class_wins[std::min(result.winner, racers.size())];
+
+        std::cout << "world " << w << ", " << name << ": "
+                  << (result.winner == NO_WINNER ? std::string_view("no winner") : racers[result.winner]);
+
+        for (std::size_t i = 0; i < racers.size(); ++i) {
+            const auto& racer = result.results[i];
+            std::cout << ", " << racers[i] << " " << to_string(racer.outcome) << " " << racer.moves
+                      << " moves " << milliseconds(racer.wall_time) << " ms";
+        }
+
+        std::cout << '\n';
+    }
+
+    std::cout.flush();
+
+    for (const auto& [name, class_wins] : wins) {
+        std::size_t races = 0;
+        for (const auto amount : class_wins) races += amount;
+
+        std::cerr << name << ": " << races << " races";
+
+        for (std::size_t i = 0; i <= racers.size(); ++i)
+            std::cerr << ", " << (i < racers.size() ? racers[i] : std::string_view("no winner")) << " " << class_wins[i]
+                      << " (" << static_cast<double>(class_wins[i]) * 100 / static_cast<double>(races) << "%)";
+
+        std::cerr << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+
+#include <unistd.h>
+
+/**
+ * @brief Reader of the judge's responses of the interactive protocol.
+ * Input is read with read(2) into the fixed buffer, integers and statuses
+ * are scanned by hand, without locales, sentries and allocations of iostream.
+ * At the end of the input every value is read as 0.
+ */
+
+class protocol_reader {
+    std::array<char, 1 << 16> _buffer {};
+    std::size_t _begin = 0;
+    std::size_t _end = 0;
+
+    /** Descriptor with the judge's responses */
+    int _fd;
+
+    /** Reads the next part of the input, returns false at the end of the input */
+    bool refill() {
+        ssize_t size = 0;
+
+        do {
+            size = ::read(_fd, _buffer.data(), _buffer.size());
+        } while (size < 0 && errno == EINTR);
+
+        _begin = 0;
+        _end = size > 0 ? static_cast<std::size_t>(size) : 0;
+        return size > 0;
+    }
+
+    /** Skips spaces and line breaks, returns false at the end of the input */
+    bool skip_whitespace() {
+        for (;;) {
+            for (; _begin < _end; ++_begin)
+                if (static_cast<unsigned char>(_buffer[_begin]) > ' ')
+                    return true;
+
+            if (!refill())
+                return false;
+        }
+    }
+
+public:
+    explicit protocol_reader(const int fd = STDIN_FILENO) : _fd(fd) {}
+
+    /** Reads the next integer */
+    [[nodiscard]] int read_int() {
+        if (!skip_whitespace())
+            return 0;
+
+        const bool is_negative = _buffer[_begin] == '-';
+
+        if (is_negative)
+            ++_begin;
+
+        int value = 0;
+
+        for (;;) {
+            for (; _begin < _end; ++_begin) {
+                const char digit = _buffer[_begin];
+
+                if (digit < '0' || digit > '9')
+                    return is_negative ? -value : value;
+
+                value = value * 10 + (digit - '0');
+            }
+
+            if (!refill())
+                return is_negative ? -value : value;
+        }
+    }
+
+    /** Reads the next character except spaces and line breaks (e.g. the cell's status) */
+    [[nodiscard]] char read_char() {
+        if (!skip_whitespace())
+            return 0;
+
+        return _buffer[_begin++];
+    }
+
+    /** Reads and discards the response to the move: number of perceived cells, then the cells */
+    void skip_response() {
+        for (int response_size = read_int(); response_size > 0; --response_size) {
+            [[maybe_unused]] const int x = read_int();
+            [[maybe_unused]] const int y = read_int();
+            [[maybe_unused]] const char status = read_char();
+        }
+    }
+};
+
+/**
+ * @brief Writer of the player's commands of the interactive protocol.
+ * Commands are formatted into the preallocated buffer and sent with the single write(2)
+ * only when the player has to wait for the response it will use. Blind moves (e.g. returns
+ * and routes through the known cells) are buffered, their responses are read and discarded
+ * after the buffer is sent, in the order of the moves.
+ */
+
+class protocol_writer {
+public:
+    /**
+     * Number of blind moves that are sent without reading their responses.
+     * Keeps unread responses smaller than the pipe's buffer,
+     * otherwise the judge blocks on writing them while the player is still writing
+     */
+    static constexpr std::size_t MAX_BLIND_MOVES = 128;
+
+private:
+    /** Longest command: "m" with two numbers of int */
+    static constexpr std::size_t MAX_COMMAND_SIZE = 32;
+
+    std::array<char, (MAX_BLIND_MOVES + 1) * MAX_COMMAND_SIZE> _buffer {};
+    std::size_t _size = 0;
+
+    /** Number of sent blind moves whose responses were not read */
+    std::size_t _unread_responses = 0;
+
+    /** Number of buffered blind moves */
+    std::size_t _blind_moves = 0;
+
+    /** Reader of the responses, used to discard responses to the blind moves */
+    protocol_reader& _input;
+
+    /** Descriptor for the player's commands */
+    int _fd;
+
+    void append_number(const int number) {
+        _buffer[_size++] = ' ';
+        _size = std::to_chars(_buffer.data() + _size, _buffer.data() + _buffer.size(), number).ptr - _buffer.data();
+    }
+
+    void append(const char command, const int first) {
+        _buffer[_size++] = command;
+        append_number(first);
+        _buffer[_size++] = '\n';
+    }
+
+    void append(const char command, const int first, const int second) {
+        _buffer[_size++] = command;
+        append_number(first);
+        append_number(second);
+        _buffer[_size++] = '\n';
+    }
+
+    /** Sends all buffered commands at once, stops if the judge closed the input */
+    void send() {
+        for (std::size_t offset = 0; offset < _size; ) {
+            const auto written = ::write(_fd, _buffer.data() + offset, _size - offset);
+
+            if (written < 0 && errno == EINTR)
+                continue;
+
+            if (written <= 0)
+                break;
+
+            offset += static_cast<std::size_t>(written);
+        }
+
+        _size = 0;
+        _unread_responses += _blind_moves;
+        _blind_moves = 0;
+    }
+
+    /** Reads and discards responses to the sent blind moves */
+    void discard_responses() {
+        for (; _unread_responses; --_unread_responses)
+            _input.skip_response();
+    }
+
+public:
+    explicit protocol_writer(protocol_reader& input, const int fd = STDOUT_FILENO) :
+        _input(input),
+        _fd(fd) {}
+
+    /**
+     * Buffers the move without the response analysis.
+     * Buffer is sent once it holds the maximum number of blind moves
+     * @param x The column of the cell to move to
+     * @param y The row of the cell to move to
+     */
+
+    void blind_move(const int x, const int y) {
+        append('m', x, y);
+
+        if (++_blind_moves < MAX_BLIND_MOVES)
+            return;
+
+        send();
+        discard_responses();
+    }
+
+    /**
+     * Sends the move with all buffered ones and discards responses to the blind moves,
+     * so the next response on the input is the response to this move
+     * @param x The column of the cell to move to
+     * @param y The row of the cell to move to
+     */
+
+    void move(const int x, const int y) {
+        append('m', x, y);
+        send();
+        discard_responses();
+    }
+
+    /**
+     * Sends the final command with all buffered moves, no responses are expected after it
+     * @param cost The cost of the shortest path to the Infinity Stone or -1
+     */
+
+    void end(const int cost) {
+        append('e', cost);
+        send();
+    }
+};
@@ -0,0 +1,111 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "solvers.h"
+#include "trace.h"
+
+/**
+ * Usage: replay [--solver astar|astar-incremental|backtracking|backtracking-goal] [--rounds N] trace...
+ *
+ * Re-runs the solver against the traces recorded with --record of the solvers' binaries
+ * (the recorded solver by default, --solver replays every trace with the given one instead)
+ * (traces are memory-mapped), verifies that all moves and the reported cost are identical
+ * and compares the time of the player's decisions with the recorded one
+ * (the best of the rounds is taken). Traces are validated before the replay (sizes of the sections,
+ * offsets of the responses, cells inside of the table), invalid ones are reported and skipped.
+ * Exits with 1 if any decision differs or any trace is invalid.
+ *
+ * Build: g++ -std=c++20 -O2 -o replay replay.cpp
+ */
+
+int main(const int argc, const char* const argv[]) {
+    std::string solver;
+    int rounds = 1;
+    std::vector<std::string> traces;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        if (arg == "--solver" && i + 1 < argc)
+            solver = argv[++i];
+        else if (arg == "--rounds" && i + 1 < argc)
+            rounds = std::max(std::atoi(argv[++i]), 1);
+        else
+            traces.emplace_back(arg);
+    }
+
+    if (!solver.empty() && !is_solver(solver)) {
+        std::cerr << "replay: unknown solver " << solver << std::endl;
+        return 1;
+    }
+
+    auto milliseconds = [](const std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    };
+
+    std::size_t identical = 0, diverged = 0, invalid = 0;
+    std::chrono::nanoseconds recorded_time {}, replayed_time {};
+
+    for (const auto& path : traces) {
+        const mapped_trace trace(path);
+
+        if (!trace.valid()) {
+            std::cout << path << ": invalid trace" << std::endl;
+            ++invalid;
+            continue;
+        }
+
+        const std::string_view trace_solver = solver.empty() ? trace.solver() : solver;
+
+        if (!is_solver(trace_solver)) {
+            std::cout << path << ": unknown solver " << trace_solver << std::endl;
+            ++invalid;
+            continue;
+        }
+
+        const auto& session = trace.session();
+        auto best_time = std::chrono::nanoseconds::max();
+        bool matches = true;
+
+        for (int round = 0; round < rounds && matches; ++round) {
+            replay_transport io(session);
+            play_solver(trace_solver, trace.table_size(), io);
+
+            if (!io.matches()) {
+                std::cout << path << ": " << trace_solver << " diverged at move " << io.divergence() << " of " << session.moves.size()
+                          << ", reported " << io.reported() << ", recorded " << session.cost << std::endl;
+
+                matches = false;
+                break;
+            }
+
+            best_time = std::min(best_time, io.decision_time());
+        }
+
+        if (!matches) {
+            ++diverged;
+            continue;
+        }
+
+        ++identical;
+        recorded_time += session.decision_time();
+        replayed_time += best_time;
+
+        std::cout << path << ": identical with " << trace_solver << ", moves " << session.moves.size()
+                  << ", decision time " << milliseconds(session.decision_time()) << " ms recorded, "
+                  << milliseconds(best_time) << " ms replayed" << std::endl;
+    }
+
+    std::cout << "identical: " << identical << std::endl
+              << "diverged: " << diverged << std::endl
+              << "invalid: " << invalid << std::endl
+              << "decision time: " << milliseconds(recorded_time) << " ms recorded, "
+              << milliseconds(replayed_time) << " ms replayed" << std::endl;
+
+    return diverged || invalid ? 1 : 0;
+}
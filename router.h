@@ -0,0 +1,241 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <type_traits>
+#include <vector>
+
+#include "grid.h"
+#include "bitboard.h"
+
+/**
+ * @brief Router over the cells known to be safe for the fixed-size tables.
+ * Distances between all pairs of known safe cells are kept in a table
+ * and updated incrementally when a new cell is added (O(k^2) for k known cells),
+ * so every route is constructed by descending the distances without any search.
+ * The judge's 9x9 table takes 81x81 distances.
+ */
+
+template <typename extent> class all_pairs_router {
+    static constexpr std::size_t CELLS = static_cast<std::size_t>(extent::width()) * extent::height();
+
+    static_assert(CELLS <= 1024, "All-pairs distances are kept only for small tables");
+
+    /** Distance between cells that are not connected through the known safe cells */
+    static constexpr std::uint16_t UNREACHABLE = UINT16_MAX;
+
+    /** Dimensions of the table, used to generate neighbours */
+    grid<char, extent> _grid;
+
+    /** Cells that are known to be safe */
+    bitboard<extent> _safe;
+
+    /** Known safe cells in the order of addition */
+    std::pmr::vector<cell_index> _known;
+
+    /** Distances between every pair of cells, row-major */
+    std::pmr::vector<std::uint16_t> _distances;
+
+    [[nodiscard]] std::uint16_t& distance(const cell_index from, const cell_index to) {
+        return _distances[from * CELLS + to];
+    }
+
+    [[nodiscard]] std::uint16_t distance(const cell_index from, const cell_index to) const {
+        return _distances[from * CELLS + to];
+    }
+
+public:
+    /** @param dimensions The game table (its memory resource is used) or its dimensions */
+    template <typename table_dimensions> explicit all_pairs_router(const table_dimensions& dimensions) :
+        _grid(dimensions, resource_of(dimensions)),
+        _safe(dimensions),
+        _known(resource_of(dimensions)),
+        _distances(CELLS * CELLS, UNREACHABLE, resource_of(dimensions)) {
+        _known.reserve(CELLS);
+    }
+
+    /** Checks whether the cell may be used by routes */
+    [[nodiscard]] bool passable(const cell_index c) const { return _safe.test(c); }
+
+    /**
+     * Adds the cell that is known to be safe and updates all distances:
+     * distances to the new cell come from its known neighbours,
+     * then every pair of cells may be connected through the new cell
+     * @param c The cell to add, ignored if it was added before
+     */
+
+    void add(const cell_index c) {
+        if (_safe.test(c))
+            return;
+
+        _safe.set(c);
+        distance(c, c) = 0;
+
+        for (const auto from : _known) {
+            int best = UNREACHABLE;
+
+            for (const auto neighbour : _grid.neighbours(c))
+                if (_safe.test(neighbour))
+                    best = std::min(best, distance(from, neighbour) + 1);
+
+            if (best < UNREACHABLE)
+                distance(from, c) = distance(c, from) = static_cast<std::uint16_t>(best);
+        }
+
+        for (const auto from : _known) {
+            const int to_new = distance(from, c);
+            if (to_new == UNREACHABLE) continue;
+
+            for (const auto to : _known) {
+                const int through_new = to_new + distance(c, to);
+
+                if (through_new < distance(from, to))
+                    distance(from, to) = static_cast<std::uint16_t>(through_new);
+            }
+        }
+
+        _known.push_back(c);
+    }
+
+    /**
+     * Constructs the shortest route between two cells through the known safe cells
+     * @param from The cell to start from
+     * @param to The cell to reach, must be reachable through the known safe cells
+     * @param route Buffer for the constructed route: all cells after the first one, in the order of moves
+     */
+
+    void route(const cell_index from, const cell_index to, std::pmr::vector<cell_index>& route) const {
+        route.clear();
+
+        for (auto c = from; c != to; ) {
+            for (const auto neighbour : _grid.neighbours(c)) {
+                if (_safe.test(neighbour) && distance(neighbour, to) + 1 == distance(c, to)) {
+                    c = neighbour;
+                    break;
+                }
+            }
+
+            route.push_back(c);
+        }
+    }
+};
+
+/**
+ * @brief Router over the cells known to be safe for the runtime-sized tables.
+ * Routes are constructed with the breadth-first search from the target,
+ * cells are stamped with the search's epoch, so no clearing and no allocations
+ * happen between searches. Distances from the last target are cached
+ * and reused until the target or the set of known cells changes.
+ */
+
+class bfs_router {
+    /** Dimensions of the table, used to generate neighbours */
+    grid<char, dynamic_extent> _grid;
+
+    /** Cells that are known to be safe */
+    row_bitboard _safe;
+
+    /** Distance from the target of the last search, valid for cells with the current epoch */
+    std::pmr::vector<int> _distance;
+
+    /** Epoch of the search that reached the cell */
+    std::pmr::vector<std::uint32_t> _epoch;
+
+    /** Queue of the breadth-first search, its head is kept to continue the cached search */
+    std::pmr::vector<cell_index> _queue;
+    std::size_t _head = 0;
+
+    std::uint32_t _current_epoch = 0;
+    cell_index _target = NO_CELL;
+
+    /** Whether the cells were added after the last search */
+    bool _is_outdated = true;
+
+    [[nodiscard]] bool reached(const cell_index c) const { return _epoch[c] == _current_epoch; }
+
+    /** Starts the new search from the target */
+    void restart(const cell_index to) {
+        ++_current_epoch;
+        _target = to;
+        _is_outdated = false;
+
+        _queue.clear();
+        _queue.push_back(to);
+        _head = 0;
+
+        _distance[to] = 0;
+        _epoch[to] = _current_epoch;
+    }
+
+    /** Continues the search until the cell is reached */
+    void search(const cell_index from) {
+        while (_head < _queue.size() && !reached(from)) {
+            const auto c = _queue[_head++];
+
+            for (const auto neighbour : _grid.neighbours(c)) {
+                if (_safe.test(neighbour) && !reached(neighbour)) {
+                    _epoch[neighbour] = _current_epoch;
+                    _distance[neighbour] = _distance[c] + 1;
+                    _queue.push_back(neighbour);
+                }
+            }
+        }
+    }
+
+public:
+    /** @param dimensions The game table (its memory resource is used) or its dimensions */
+    template <typename extent> explicit bfs_router(const extent& dimensions) :
+        _grid(dynamic_extent(dimensions.width(), dimensions.height()), resource_of(dimensions)),
+        _safe(dimensions),
+        _distance(_grid.size(), _grid.resource()),
+        _epoch(_grid.size(), _grid.resource()),
+        _queue(_grid.resource()) {
+        _queue.reserve(_grid.size());
+    }
+
+    /** Checks whether the cell may be used by routes */
+    [[nodiscard]] bool passable(const cell_index c) const { return _safe.test(c); }
+
+    /**
+     * Adds the cell that is known to be safe
+     * @param c The cell to add, ignored if it was added before
+     */
+
+    void add(const cell_index c) {
+        if (_safe.test(c))
+            return;
+
+        _safe.set(c);
+        _is_outdated = true;
+    }
+
+    /**
+     * Constructs the shortest route between two cells through the known safe cells
+     * @param from The cell to start from
+     * @param to The cell to reach, must be reachable through the known safe cells
+     * @param route Buffer for the constructed route: all cells after the first one, in the order of moves
+     */
+
+    void route(const cell_index from, const cell_index to, std::pmr::vector<cell_index>& route) {
+        if (_is_outdated || to != _target)
+            restart(to);
+
+        search(from);
+        route.clear();
+
+        for (auto c = from; c != to; ) {
+            for (const auto neighbour : _grid.neighbours(c)) {
+                if (reached(neighbour) && _distance[neighbour] + 1 == _distance[c]) {
+                    c = neighbour;
+                    break;
+                }
+            }
+
+            route.push_back(c);
+        }
+    }
+};
+
+/** Router over the known safe cells: all-pairs distances for the fixed-size tables, BFS for the runtime-sized ones */
+template <typename extent> using travel_router = std::conditional_t<is_fixed_extent_v<extent>, all_pairs_router<extent>, bfs_router>;
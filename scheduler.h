@@ -0,0 +1,152 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+/**
+ * Work-stealing scheduler of the batch jobs. Jobs are known in advance (e.g. worlds with solvers)
+ * and are identified by their indices. Every worker starts with the contiguous block of jobs
+ * in its own deque and takes jobs from the back of it; a worker with the empty deque steals
+ * from the front of the other workers' deques, so the long jobs (e.g. full explorations
+ * of maps with unreachable stones) never leave the other workers idle.
+ * Jobs do not spawn new jobs, so the batch is finished once all deques are empty.
+ * Static split (the same blocks without stealing) is kept for the comparison.
+ */
+
+/** @brief Distribution of the jobs between the workers */
+enum class schedule {
+    /** Every worker executes only its own contiguous block of jobs */
+    static_split,
+
+    /** Workers start with their blocks and steal the jobs of others when they run out of their own */
+    work_stealing
+};
+
+/** @brief Deque of job indices of the single worker: the owner pops from the back, thieves steal from the front */
+
+class alignas(64) job_deque {
+    std::mutex _mutex;
+
+    /** Jobs [_front, _back) */
+    std::size_t _front = 0;
+    std::size_t _back = 0;
+
+public:
+    /** Replaces the jobs with [first, last) */
+    void assign(const std::size_t first, const std::size_t last) {
+        const std::lock_guard lock(_mutex);
+        _front = first;
+        _back = last;
+    }
+
+    /** Takes the last job, called only by the owner */
+    [[nodiscard]] std::optional<std::size_t> pop() {
+        const std::lock_guard lock(_mutex);
+
+        if (_front == _back)
+            return std::nullopt;
+
+        return --_back;
+    }
+
+    /** Takes the first job, called by other workers */
+    [[nodiscard]] std::optional<std::size_t> steal() {
+        const std::lock_guard lock(_mutex);
+
+        if (_front == _back)
+            return std::nullopt;
+
+        return _front++;
+    }
+};
+
+/** @brief Statistics of the worker of the batch, on its own cache line */
+struct alignas(64) worker_load {
+    /** Number of executed jobs */
+    std::size_t jobs = 0;
+
+    /** Number of jobs stolen from other workers */
+    std::size_t stolen = 0;
+
+    /** Time spent executing jobs */
+    std::chrono::nanoseconds busy_time {};
+
+    /** Time from the start of the batch to the moment the worker ran out of jobs */
+    std::chrono::nanoseconds active_time {};
+
+    /**
+     * Utilisation of the worker during the batch
+     * @param wall_time Time of the whole batch
+     */
+
+    [[nodiscard]] double utilisation(const std::chrono::nanoseconds wall_time) const {
+        return wall_time.count() ? static_cast<double>(busy_time.count()) / static_cast<double>(wall_time.count()) : 0;
+    }
+};
+
+/**
+ * Executes all jobs with one thread per worker
+ * @param policy Distribution of the jobs between the workers
+ * @param jobs Number of jobs
+ * @param loads Statistics of the workers, its size is the number of workers
+ * @param run Function called with the worker's index and the job's index
+ */
+
+template <typename F> void run_scheduled(
+        const schedule policy,
+        const std::size_t jobs,
+        std::vector<worker_load>& loads,
+        F&& run
+) {
+    using clock = std::chrono::steady_clock;
+
+    const auto workers = loads.size();
+    std::vector<job_deque> deques(workers);
+
+    for (std::size_t w = 0; w < workers; ++w)
+        deques[w].assign(jobs * w / workers, jobs * (w + 1) / workers);
+
+    const auto start = clock::now();
+    std::vector<std::thread> threads;
+    threads.reserve(workers);
+
+    for (std::size_t w = 0; w < workers; ++w) {
+        threads.emplace_back([&, w] {
+            auto& load = loads[w];
+
+            // Own jobs first, then the victims in the round-robin order
+            auto next_job = [&]() -> std::optional<std::size_t> {
+                if (const auto job = deques[w].pop())
+                    return job;
+
+                if (policy == schedule::static_split)
+                    return std::nullopt;
+
+                for (std::size_t i = 1; i < workers; ++i) {
+                    if (const auto job = deques[(w + i) % workers].steal()) {
+                        ++load.stolen;
+                        return job;
+                    }
+                }
+
+                return std::nullopt;
+            };
+
+            while (const auto job = next_job()) {
+                const auto job_start = clock::now();
+                run(w, *job);
+                load.busy_time += clock::now() - job_start;
+                ++load.jobs;
+            }
+
+            load.active_time = clock::now() - start;
+        });
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+}
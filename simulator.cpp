@@ -0,0 +1,150 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "simulator.h"
+#include "solvers.h"
+
+/**
+ * Plays the game with the solver in the same process
+ * @param solver Name of the solver: astar, astar-incremental, backtracking or backtracking-goal
+ * @param world The world of the game
+ * @param pipes Whether to play over the pipes with the judge's text protocol
+ * instead of the direct calls of the simulator
+ * @param buffers Buffers of the game, reused by the following games
+ */
+
+[[nodiscard]] run_result run_solver(
+        const std::string_view solver,
+        const game_world& world,
+        const bool pipes,
+        game_buffers& buffers
+) {
+    auto play_world = [&](auto& io) { play_solver(solver, world.size, io); };
+
+    if (!pipes)
+        return run_direct(world, buffers, play_world);
+
+    return run_in_process(world, buffers, [&](const int input, const int output) {
+        stdio_transport io(input, output);
+        play_world(io);
+    });
+}
+
+/**
+ * Usage: simulator [--seeds N] [--first-seed S] [--size N] [--variant 1|2]
+ *                  [--solver astar|astar-incremental|backtracking|backtracking-goal] [--pipes] [--verbose] [--dump]
+ *                  [-- command...]
+ *
+ * Generates worlds with the judge's rules for every seed and both Thanos perception variants
+ * (or only the given one), plays them with the solver and checks the reported costs.
+ * Solvers from this repository are run in-process with direct calls of the simulator
+ * (or over the pipes with the judge's text protocol with --pipes), any other player is started
+ * as the child process with the command after "--", e.g.
+ * simulator --size 20 -- ./astar --size 20
+ * With --dump the worlds are not played, their descriptions are written to stdout (for the batch solver).
+ *
+ * Build: g++ -std=c++20 -O2 -pthread -o simulator simulator.cpp
+ */
+
+int main(const int argc, const char* const argv[]) {
+    int seeds = 100;
+    int first_seed = 0;
+    int size = TABLE_SIZE;
+    int variant = 0;
+    bool verbose = false;
+    bool pipes = false;
+    bool dump = false;
+    std::string solver = "astar";
+    std::vector<std::string> command;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+
+        if (arg == "--") {
+            command.assign(argv + i + 1, argv + argc);
+            break;
+        }
+
+        if (arg == "--verbose")
+            verbose = true;
+        else if (arg == "--pipes")
+            pipes = true;
+        else if (arg == "--dump")
+            dump = true;
+        else if (i + 1 >= argc)
+            break;
+        else if (arg == "--seeds")
+            seeds = std::atoi(argv[++i]);
+        else if (arg == "--first-seed")
+            first_seed = std::atoi(argv[++i]);
+        else if (arg == "--size")
+            size = std::atoi(argv[++i]);
+        else if (arg == "--variant")
+            variant = std::atoi(argv[++i]);
+        else if (arg == "--solver")
+            solver = argv[++i];
+    }
+
+    if (!is_solver(solver)) {
+        std::cerr << "simulator: unknown solver " << solver << std::endl;
+        return 1;
+    }
+
+    std::map<std::string_view, int> verdicts;
+    std::size_t moves = 0;
+    std::chrono::nanoseconds wall_time {}, io_time {}, wait_time {};
+    game_buffers buffers;
+
+    for (int seed = first_seed; seed < first_seed + seeds; ++seed) {
+        for (int thanos_variant = 1; thanos_variant <= 2; ++thanos_variant) {
+            if (variant && variant != thanos_variant)
+                continue;
+
+            // Both variants are played in the same world
+            std::mt19937 rng(seed);
+            const auto world = generate_game_world(rng, size, thanos_variant);
+
+            if (dump) {
+                write_game_world(std::cout, world);
+                continue;
+            }
+
+            const auto result = command.empty()
+                    ? run_solver(solver, world, pipes, buffers)
+                    : run_over_pipe(world, command, buffers);
+
+            ++verdicts[to_string(result.outcome)];
+            moves += result.moves;
+            wall_time += result.wall_time;
+            io_time += result.io_time;
+            wait_time += result.wait_time;
+
+            if (verbose || result.outcome != verdict::accepted)
+                std::cout << "seed " << seed << ", variant " << thanos_variant << ": " << to_string(result.outcome)
+                          << ", reported " << result.reported << ", expected " << result.expected
+                          << ", moves " << result.moves << std::endl;
+        }
+    }
+
+    if (dump)
+        return 0;
+
+    auto milliseconds = [](const std::chrono::nanoseconds time) {
+        return std::chrono::duration<double, std::milli>(time).count();
+    };
+
+    for (const auto& [outcome, amount] : verdicts)
+        std::cout << outcome << ": " << amount << std::endl;
+
+    std::cout << "moves: " << moves << std::endl
+              << "wall time: " << milliseconds(wall_time) << " ms" << std::endl
+              << "io time: " << milliseconds(io_time) << " ms" << std::endl
+              << "wait time: " << milliseconds(wait_time) << " ms" << std::endl;
+
+    return 0;
+}
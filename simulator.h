@@ -0,0 +1,883 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdlib>
+#include <charconv>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "grid.h"
+#include "heroes.h"
+#include "transport.h"
+
+/**
+ * @brief Generated world of the game with the same rules as the judge's ones:
+ * Hulk, Thor and Captain Marvel with their perception zones (more of every hero in the larger tables),
+ * the shield and the Infinity Stone.
+ * The initial cell, the shield and the stone are never dangerous. Once the player has taken the shield,
+ * the perception zones of Hulk and Thor are safe, the heroes' own cells and the zone of Captain Marvel are not.
+ */
+
+struct game_world {
+    /** Size of the square table */
+    int size = TABLE_SIZE;
+
+    /** Thanos perception variant: 1 (Moore neighbourhood) or 2 (Moore neighbourhood with ears) */
+    int thanos_variant = 1;
+
+    /** Status of every cell in row-major order, 0 for the empty cell */
+    std::vector<char> statuses;
+
+    /** Heroes whose perception zones cover every cell in row-major order */
+    std::vector<hero_mask> zones;
+
+    int inf_stone_n = 0;
+    int inf_stone_m = 0;
+
+    /** Length of the shortest safe path to the Infinity Stone, -1 if it is unreachable */
+    int shortest_path = -1;
+
+    [[nodiscard]] bool in_borders(const int n, const int m) const {
+        return n >= 0 && n < size && m >= 0 && m < size;
+    }
+
+    [[nodiscard]] char status(const int n, const int m) const { return statuses[n * size + m]; }
+
+    /**
+     * Whether the player dies in the cell
+     * @param n The row of the cell
+     * @param m The column of the cell
+     * @param has_shield Whether the player has taken the shield
+     */
+
+    [[nodiscard]] bool is_deadly(const int n, const int m, const bool has_shield) const {
+        const auto cell_status = status(n, m);
+
+        if (!dangerous_status(cell_status))
+            return false;
+
+        return cell_status != 'P' || !has_shield || (zones[n * size + m] & CAPTAIN_MARVEL);
+    }
+};
+
+/**
+ * Marks the perception zones of all heroes of the world by their cells
+ * @param world The world with the statuses
+ */
+
+inline void mark_hero_zones(game_world& world) {
+    world.zones.assign(world.statuses.size(), 0);
+
+    for (int hero_n = 0; hero_n < world.size; ++hero_n) {
+        for (int hero_m = 0; hero_m < world.size; ++hero_m) {
+            const auto hero = heroes_of_status(world.status(hero_n, hero_m));
+
+            if (hero == 0 || hero == ALL_HEROES)
+                continue;
+
+            for (const auto& [dn, dm] : zone_of(hero)) {
+                const int n = hero_n + dn;
+                const int m = hero_m + dm;
+
+                if (world.in_borders(n, m))
+                    world.zones[n * world.size + m] |= hero;
+            }
+        }
+    }
+}
+
+/**
+ * Calculates the length of the shortest safe path from the initial cell
+ * to the Infinity Stone with the breadth-first search (the reference answer).
+ * The state of the search is the cell and whether the shield is taken,
+ * so the path may go through the shield to pass the zones of Hulk and Thor
+ * @return length of the path, -1 if the stone is unreachable
+ */
+
+[[nodiscard]] inline int shortest_safe_path(const game_world& world) {
+    // Distances of the states: the cell without the shield, then the cell with it
+    std::vector<int> distance(world.statuses.size() * 2, -1);
+    std::vector<std::pair<int, int>> queue = { { 0, 0 } };
+    distance[0] = 0;
+
+    for (std::size_t head = 0; head < queue.size(); ++head) {
+        const auto [cell, has_shield] = queue[head];
+        const int n = cell / world.size;
+        const int m = cell % world.size;
+
+        for (const auto& [dn, dm] : HULK_ZONE) {
+            const int next_n = n + dn;
+            const int next_m = m + dm;
+
+            if (!world.in_borders(next_n, next_m) || world.is_deadly(next_n, next_m, has_shield))
+                continue;
+
+            const int next = next_n * world.size + next_m;
+            const int next_has_shield = has_shield || world.status(next_n, next_m) == 'S';
+            auto& next_distance = distance[next * 2 + next_has_shield];
+
+            if (next_distance == -1) {
+                next_distance = distance[cell * 2 + has_shield] + 1;
+                queue.emplace_back(next, next_has_shield);
+            }
+        }
+    }
+
+    const int stone = world.inf_stone_n * world.size + world.inf_stone_m;
+    const int without_shield = distance[stone * 2], with_shield = distance[stone * 2 + 1];
+
+    if (without_shield < 0 || with_shield < 0)
+        return std::max(without_shield, with_shield);
+
+    return std::min(without_shield, with_shield);
+}
+
+/** Number of cells of the table per hero of every kind, as many as in the judge's table */
+constexpr int CELLS_PER_HERO = TABLE_SIZE * TABLE_SIZE;
+
+/**
+ * Number of heroes of every kind in the generated table: one in the judge's table,
+ * proportionally more in the larger ones, so the density of the dangerous cells
+ * (and the share of the unreachable stones) does not fall with the size of the table
+ * @param size Size of the square table
+ */
+
+[[nodiscard]] constexpr int heroes_per_kind(const int size) {
+    return std::max((size * size + CELLS_PER_HERO / 2) / CELLS_PER_HERO, 1);
+}
+
+/**
+ * Generates the world with randomly placed heroes, shield and the Infinity Stone
+ * @param rng Random generator, so the same worlds are generated for the same seed
+ * @param size Size of the square table
+ * @param thanos_variant Thanos perception variant: 1 or 2
+ */
+
+[[nodiscard]] inline game_world generate_game_world(std::mt19937& rng, const int size, const int thanos_variant) {
+    game_world world;
+    world.size = size;
+    world.thanos_variant = thanos_variant;
+
+    const auto cells = static_cast<std::size_t>(size) * size;
+    const auto heroes = static_cast<std::size_t>(heroes_per_kind(size));
+    std::vector<int> order(cells - 1);
+
+    for (;;) {
+        // Picking different cells for the heroes (Hulk, Thor and Captain Marvel in turn),
+        // the shield and the stone except the initial one
+        for (std::size_t i = 0; i < order.size(); ++i)
+            order[i] = static_cast<int>(i + 1);
+
+        for (std::size_t i = 0; i < heroes * 3 + 2; ++i)
+            std::swap(order[i], order[std::uniform_int_distribution<std::size_t>(i, order.size() - 1)(rng)]);
+
+        const int shield = order[heroes * 3], inf_stone = order[heroes * 3 + 1];
+
+        world.statuses.assign(cells, 0);
+
+        auto mark_zone = [&](const int hero, const auto& zone) {
+            for (const auto& [dn, dm] : zone) {
+                const int n = hero / size + dn;
+                const int m = hero % size + dm;
+
+                if (world.in_borders(n, m))
+                    world.statuses[n * size + m] = 'P';
+            }
+        };
+
+        for (std::size_t i = 0; i < heroes; ++i) {
+            mark_zone(order[i * 3], HULK_ZONE);
+            mark_zone(order[i * 3 + 1], THOR_ZONE);
+            mark_zone(order[i * 3 + 2], CAPTAIN_MARVEL_ZONE);
+        }
+
+        for (std::size_t i = 0; i < heroes; ++i) {
+            world.statuses[order[i * 3]] = 'H';
+            world.statuses[order[i * 3 + 1]] = 'T';
+            world.statuses[order[i * 3 + 2]] = 'M';
+        }
+
+        if (world.statuses[0] || world.statuses[shield] || world.statuses[inf_stone])
+            continue;
+
+        world.statuses[shield] = 'S';
+        world.statuses[inf_stone] = 'I';
+        mark_hero_zones(world);
+        world.inf_stone_n = inf_stone / size;
+        world.inf_stone_m = inf_stone % size;
+        world.shortest_path = shortest_safe_path(world);
+        return world;
+    }
+}
+
+/**
+ * Writes the description of the world: the line with the size and the Thanos perception variant,
+ * then the rows of the table with the status of every cell ('.' for the empty cell)
+ * @param out The stream for the description
+ * @param world The world to describe
+ */
+
+inline void write_game_world(std::ostream& out, const game_world& world) {
+    out << world.size << ' ' << world.thanos_variant << '\n';
+
+    for (int n = 0; n < world.size; ++n) {
+        for (int m = 0; m < world.size; ++m)
+            out << (world.status(n, m) ? world.status(n, m) : '.');
+
+        out << '\n';
+    }
+}
+
+/**
+ * Reads the description of the world written with write_game_world,
+ * the position of the stone, the zones of the heroes and the shortest path are restored from the statuses
+ * @param in The stream with the descriptions
+ * @param world The world to fill
+ * @return false if there are no more descriptions or the description is invalid
+ */
+
+[[nodiscard]] inline bool read_game_world(std::istream& in, game_world& world) {
+    if (!(in >> world.size >> world.thanos_variant) || world.size <= 0
+            || (world.thanos_variant != 1 && world.thanos_variant != 2))
+        return false;
+
+    world.statuses.assign(static_cast<std::size_t>(world.size) * world.size, 0);
+    int stones = 0;
+    std::string row;
+
+    for (int n = 0; n < world.size; ++n) {
+        if (!(in >> row) || row.size() != static_cast<std::size_t>(world.size))
+            return false;
+
+        for (int m = 0; m < world.size; ++m) {
+            const char status = row[m];
+
+            if (status != '.' && status != 'I' && status != 'S' && !dangerous_status(status))
+                return false;
+
+            if (status == 'I') {
+                world.inf_stone_n = n;
+                world.inf_stone_m = m;
+                ++stones;
+            }
+
+            world.statuses[n * world.size + m] = status == '.' ? 0 : status;
+        }
+    }
+
+    if (stones != 1 || world.statuses[0])
+        return false;
+
+    mark_hero_zones(world);
+    world.shortest_path = shortest_safe_path(world);
+    return true;
+}
+
+/** @brief Outcome of the single game */
+enum class verdict {
+    /** Reported cost is the length of the shortest path */
+    accepted,
+
+    /** Reported cost differs from the length of the shortest path */
+    wrong_answer,
+
+    /** Player moved to the dangerous cell */
+    dead,
+
+    /** Player moved outside of the table, further than to the neighbouring cell or sent an unknown command */
+    bad_move,
+
+    /** Player made too many moves */
+    move_limit,
+
+    /** Player finished without the answer */
+    no_answer,
+
+    /** Game was cancelled before the answer, e.g. the rival solver of the portfolio race has won */
+    cancelled
+};
+
+[[nodiscard]] inline std::string_view to_string(const verdict outcome) {
+    switch (outcome) {
+        case verdict::accepted: return "accepted";
+        case verdict::wrong_answer: return "wrong_answer";
+        case verdict::dead: return "dead";
+        case verdict::bad_move: return "bad_move";
+        case verdict::move_limit: return "move_limit";
+        case verdict::no_answer: return "no_answer";
+        case verdict::cancelled: return "cancelled";
+    }
+
+    return "unknown";
+}
+
+/** @brief Statistics of the single game */
+struct run_result {
+    verdict outcome = verdict::no_answer;
+
+    /** Cost reported by the player */
+    int reported = -1;
+
+    /** Length of the shortest path */
+    int expected = -1;
+
+    /** Number of moves, every move is a round-trip of the interactive protocol */
+    std::size_t moves = 0;
+
+    /** Number of different cells entered by the player (expansions of its search) */
+    std::size_t cells_entered = 0;
+
+    /** Time from the first request to the verdict */
+    std::chrono::nanoseconds wall_time {};
+
+    /** Time spent by the simulator in read(2) and write(2) */
+    std::chrono::nanoseconds io_time {};
+
+    /** Time spent by the simulator waiting for the player's commands (player's decisions and I/O) */
+    std::chrono::nanoseconds wait_time {};
+};
+
+/**
+ * @brief Per-game buffers of the simulator, reused by the games played one after another
+ * (e.g. by the same worker), so their storage is allocated only while it grows
+ */
+
+struct game_buffers {
+    /** Maximum number of reserved move latencies, so the large tables do not reserve the whole moves limit */
+    static constexpr std::size_t MAX_RESERVED_LATENCIES = 1 << 20;
+
+    /** Cells entered by the player during the game */
+    std::vector<bool> entered;
+
+    /** Time from every response to the next move of the last game */
+    std::vector<std::chrono::nanoseconds> move_latencies;
+
+    /**
+     * Prepares the buffers for the next game, keeping their storage
+     * @param world The world of the game
+     * @param max_moves Number of moves after which the game is stopped
+     */
+
+    void reset(const game_world& world, const std::size_t max_moves) {
+        entered.assign(world.statuses.size(), false);
+        move_latencies.clear();
+
+        // Latencies are reserved, so the player's allocations may be counted separately
+        move_latencies.reserve(std::min(max_moves + 1, MAX_RESERVED_LATENCIES));
+    }
+};
+
+/**
+ * Calls the function for every perceived cell with any events
+ * @param world The world of the game
+ * @param n The row of the player's cell
+ * @param m The column of the player's cell
+ * @param on_cell Function called with the row, the column and the status of the perceived cell
+ */
+
+template <typename F> void for_each_perceived_event(const game_world& world, const int n, const int m, F&& on_cell) {
+    const auto& perception = world.thanos_variant == 2
+            ? std::span<const std::pair<int, int>>(SECOND_PERCEPTION)
+            : std::span<const std::pair<int, int>>(FIRST_PERCEPTION);
+
+    for (const auto& [dn, dm] : perception) {
+        const int perceived_n = n + dn;
+        const int perceived_m = m + dm;
+
+        if (world.in_borders(perceived_n, perceived_m) && world.status(perceived_n, perceived_m))
+            on_cell(perceived_n, perceived_m, world.status(perceived_n, perceived_m));
+    }
+}
+
+/**
+ * Formats the response to the move: number of perceived cells with any events,
+ * then the cells with their statuses (column, row, status)
+ * @param world The world of the game
+ * @param n The row of the player's cell
+ * @param m The column of the player's cell
+ * @param response Buffer for the response
+ */
+
+inline void perception_response(const game_world& world, const int n, const int m, std::string& response) {
+    std::string events;
+    int amount = 0;
+
+    for_each_perceived_event(world, n, m, [&](const int perceived_n, const int perceived_m, const char status) {
+        events += std::to_string(perceived_m) + ' ' + std::to_string(perceived_n) + ' ' + status + '\n';
+        ++amount;
+    });
+
+    response = std::to_string(amount) + '\n' + events;
+}
+
+/**
+ * @brief Judge's side of the interactive protocol over the pair of file descriptors.
+ * Waiting for the player's commands (poll(2)) and the I/O itself (read(2), write(2))
+ * are timed separately.
+ */
+
+class interactor {
+    using clock = std::chrono::steady_clock;
+
+    /** Commands of the player */
+    int _input;
+
+    /** Responses to the player */
+    int _output;
+
+    std::array<char, 4096> _buffer {};
+    std::size_t _begin = 0;
+    std::size_t _end = 0;
+
+    run_result& _result;
+    game_buffers& _buffers;
+
+    /** Reads the next command, returns false once the player closed the output */
+    bool read_line(std::string& line) {
+        line.clear();
+
+        for (;;) {
+            const auto* begin = _buffer.data() + _begin;
+            const auto* end = _buffer.data() + _end;
+            const auto* line_end = std::find(begin, end, '\n');
+
+            line.append(begin, line_end);
+
+            if (line_end != end) {
+                _begin = line_end - _buffer.data() + 1;
+                return true;
+            }
+
+            _begin = _end = 0;
+
+            // Waiting for the player's decision
+            const auto wait_start = clock::now();
+            pollfd request { _input, POLLIN, 0 };
+
+            while (::poll(&request, 1, -1) < 0 && errno == EINTR) {}
+
+            const auto read_start = clock::now();
+            _result.wait_time += read_start - wait_start;
+
+            ssize_t size = 0;
+
+            do {
+                size = ::read(_input, _buffer.data(), _buffer.size());
+            } while (size < 0 && errno == EINTR);
+
+            _result.io_time += clock::now() - read_start;
+
+            if (size <= 0)
+                return !line.empty();
+
+            _end = static_cast<std::size_t>(size);
+        }
+    }
+
+    /** Writes the whole response, stops if the player closed the input */
+    void write_all(const std::string_view data) {
+        const auto start = clock::now();
+        std::size_t offset = 0;
+
+        while (offset < data.size()) {
+            const auto written = ::write(_output, data.data() + offset, data.size() - offset);
+
+            if (written < 0 && errno == EINTR)
+                continue;
+
+            if (written <= 0)
+                break;
+
+            offset += static_cast<std::size_t>(written);
+        }
+
+        _result.io_time += clock::now() - start;
+    }
+
+    /** Parses the integer arguments of the command */
+    template <std::size_t amount> [[nodiscard]] static bool parse_arguments(
+            const std::string_view command,
+            std::array<int, amount>& arguments
+    ) {
+        const auto* it = command.data() + 1;
+        const auto* end = command.data() + command.size();
+
+        for (auto& argument : arguments) {
+            while (it < end && *it == ' ') ++it;
+
+            const auto [next, error] = std::from_chars(it, end, argument);
+            if (error != std::errc()) return false;
+            it = next;
+        }
+
+        return true;
+    }
+
+public:
+    /**
+     * @param input Descriptor with the player's commands
+     * @param output Descriptor for the responses to the player
+     * @param result Statistics of the game to fill
+     * @param buffers Buffers of the game, reused by the following games
+     */
+
+    interactor(const int input, const int output, run_result& result, game_buffers& buffers) :
+        _input(input),
+        _output(output),
+        _result(result),
+        _buffers(buffers) {}
+
+    /**
+     * Plays the whole game with the player and fills the statistics
+     * @param world The world of the game
+     * @param max_moves Number of moves after which the game is stopped
+     */
+
+    void play(const game_world& world, const std::size_t max_moves) {
+        const auto start = clock::now();
+        _result.expected = world.shortest_path;
+        _buffers.reset(world, max_moves);
+
+        // Thanos perception variant and coordinates of the stone (column, then row)
+        std::string response = std::to_string(world.thanos_variant) + '\n'
+                + std::to_string(world.inf_stone_m) + ' ' + std::to_string(world.inf_stone_n) + '\n';
+
+        write_all(response);
+
+        auto last_response = clock::now();
+        int pos_n = 0, pos_m = 0;
+        bool has_shield = false;
+        std::string command;
+        auto& entered = _buffers.entered;
+
+        while (read_line(command)) {
+            if (command.starts_with('e')) {
+                std::array<int, 1> cost {};
+
+                if (!parse_arguments(command, cost)) {
+                    _result.outcome = verdict::bad_move;
+                    break;
+                }
+
+                _result.reported = cost[0];
+                _result.outcome = cost[0] == world.shortest_path ? verdict::accepted : verdict::wrong_answer;
+                break;
+            }
+
+            std::array<int, 2> coordinates {};
+
+            if (!command.starts_with('m') || !parse_arguments(command, coordinates)) {
+                _result.outcome = verdict::bad_move;
+                break;
+            }
+
+            const auto [m, n] = coordinates;
+
+            if (!world.in_borders(n, m) || std::abs(n - pos_n) + std::abs(m - pos_m) > 1) {
+                _result.outcome = verdict::bad_move;
+                break;
+            }
+
+            if (world.is_deadly(n, m, has_shield)) {
+                _result.outcome = verdict::dead;
+                break;
+            }
+
+            _buffers.move_latencies.push_back(clock::now() - last_response);
+
+            if (++_result.moves > max_moves) {
+                _result.outcome = verdict::move_limit;
+                break;
+            }
+
+            pos_n = n;
+            pos_m = m;
+            has_shield |= world.status(n, m) == 'S';
+
+            if (!entered[n * world.size + m]) {
+                entered[n * world.size + m] = true;
+                ++_result.cells_entered;
+            }
+
+            // Player may finish right after the last move without reading the response,
+            // its remaining commands are still read
+            perception_response(world, n, m, response);
+            write_all(response);
+
+            last_response = clock::now();
+        }
+
+        _result.wall_time = clock::now() - start;
+    }
+};
+
+/** Moves limit of the game: every cell may be visited many times by the backtracking */
+[[nodiscard]] inline std::size_t max_moves(const game_world& world) {
+    return static_cast<std::size_t>(world.size) * world.size * 16 + 1000;
+}
+
+/**
+ * @brief Transport that plays with the simulator in the same thread with direct calls,
+ * without any text, pipes or system calls. Moves are checked with the judge's rules,
+ * once the game is stopped (e.g. the player is dead), all following responses are empty.
+ * Statistics of the game are the same as the interactor's ones except the I/O times.
+ */
+
+class direct_transport {
+    using clock = std::chrono::steady_clock;
+
+    const game_world& _world;
+    run_result& _result;
+    game_buffers& _buffers;
+    std::size_t _max_moves;
+
+    int _pos_n = 0;
+    int _pos_m = 0;
+    bool _has_shield = false;
+
+    std::array<perceived_cell, MAX_RESPONSE_SIZE> _response {};
+    std::size_t _response_size = 0;
+
+    bool _is_finished = false;
+    clock::time_point _last_response;
+
+    void finish(const verdict outcome) {
+        _result.outcome = outcome;
+        _is_finished = true;
+    }
+
+public:
+    /**
+     * @param world The world of the game
+     * @param result Statistics of the game to fill
+     * @param buffers Buffers of the game, reused by the following games
+     * @param max_moves Number of moves after which the game is stopped
+     */
+
+    direct_transport(
+            const game_world& world,
+            run_result& result,
+            game_buffers& buffers,
+            const std::size_t max_moves
+    ) :
+        _world(world),
+        _result(result),
+        _buffers(buffers),
+        _max_moves(max_moves) {
+        _buffers.reset(world, max_moves);
+    }
+
+    [[nodiscard]] game_start start() {
+        _result.expected = _world.shortest_path;
+        _last_response = clock::now();
+        return { _world.thanos_variant, _world.inf_stone_m, _world.inf_stone_n };
+    }
+
+    void blind_move(const int x, const int y) { move(x, y); }
+
+    void move(const int x, const int y) {
+        _response_size = 0;
+
+        if (_is_finished)
+            return;
+
+        const int n = y, m = x;
+
+        if (!_world.in_borders(n, m) || std::abs(n - _pos_n) + std::abs(m - _pos_m) > 1)
+            return finish(verdict::bad_move);
+
+        if (_world.is_deadly(n, m, _has_shield))
+            return finish(verdict::dead);
+
+        _buffers.move_latencies.push_back(clock::now() - _last_response);
+
+        if (++_result.moves > _max_moves)
+            return finish(verdict::move_limit);
+
+        _pos_n = n;
+        _pos_m = m;
+        _has_shield |= _world.status(n, m) == 'S';
+
+        if (!_buffers.entered[n * _world.size + m]) {
+            _buffers.entered[n * _world.size + m] = true;
+            ++_result.cells_entered;
+        }
+
+        for_each_perceived_event(_world, n, m, [&](const int perceived_n, const int perceived_m, const char status) {
+            _response[_response_size++] = { perceived_m, perceived_n, status };
+        });
+
+        _last_response = clock::now();
+    }
+
+    [[nodiscard]] std::span<const perceived_cell> response() const { return { _response.data(), _response_size }; }
+
+    void end(const int cost) {
+        if (_is_finished)
+            return;
+
+        _result.reported = cost;
+        finish(cost == _world.shortest_path ? verdict::accepted : verdict::wrong_answer);
+    }
+};
+
+/**
+ * Plays the game with the player in the same thread through direct_transport
+ * @param world The world of the game
+ * @param buffers Buffers of the game, reused by the following games
+ * @param player Function that plays the whole game, called with the transport
+ * @return statistics of the game
+ */
+
+template <typename F> [[nodiscard]] run_result run_direct(const game_world& world, game_buffers& buffers, F&& player) {
+    run_result result;
+    direct_transport io(world, result, buffers, max_moves(world));
+
+    const auto start = std::chrono::steady_clock::now();
+    player(io);
+    result.wall_time = std::chrono::steady_clock::now() - start;
+
+    return result;
+}
+
+/** Time given to the player to finish on its own after the game, then it is killed */
+constexpr std::chrono::milliseconds CHILD_EXIT_TIMEOUT(1000);
+
+/**
+ * Waits for the child process to exit
+ * @param pid The child process
+ * @param timeout Time to wait
+ * @return false if the child is still running after the timeout
+ */
+
+[[nodiscard]] inline bool wait_child(const pid_t pid, const std::chrono::milliseconds timeout) {
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    for (auto delay = std::chrono::microseconds(100); ; delay = std::min(delay * 2, std::chrono::microseconds(10000))) {
+        const auto exited = ::waitpid(pid, nullptr, WNOHANG);
+
+        if (exited == pid || (exited < 0 && errno != EINTR))
+            return true;
+
+        if (std::chrono::steady_clock::now() >= deadline)
+            return false;
+
+        std::this_thread::sleep_for(delay);
+    }
+}
+
+/**
+ * Plays the game with the player in the child process, connected over the pipes
+ * @param world The world of the game
+ * @param command The player's executable with its arguments
+ * @param buffers Buffers of the game, reused by the following games
+ * @return statistics of the game
+ */
+
+[[nodiscard]] inline run_result run_over_pipe(
+        const game_world& world,
+        const std::vector<std::string>& command,
+        game_buffers& buffers
+) {
+    std::signal(SIGPIPE, SIG_IGN);
+
+    int to_player[2], from_player[2];
+
+    if (::pipe(to_player) < 0 || ::pipe(from_player) < 0) {
+        std::cerr << "simulator: failed to create pipes" << std::endl;
+        return {};
+    }
+
+    const auto pid = ::fork();
+
+    if (pid == 0) {
+        ::dup2(to_player[0], STDIN_FILENO);
+        ::dup2(from_player[1], STDOUT_FILENO);
+
+        for (const int fd : { to_player[0], to_player[1], from_player[0], from_player[1] })
+            ::close(fd);
+
+        std::vector<char*> arguments;
+
+        for (const auto& argument : command)
+            arguments.push_back(const_cast<char*>(argument.c_str()));
+
+        arguments.push_back(nullptr);
+        ::execvp(arguments[0], arguments.data());
+        ::_exit(127);
+    }
+
+    ::close(to_player[0]);
+    ::close(from_player[1]);
+
+    run_result result;
+    interactor(from_player[0], to_player[1], result, buffers).play(world, max_moves(world));
+
+    // Player reads the end of file and its writes fail, so it finishes on its own
+    // and its output at the exit (e.g. the instrumentation summary) is not lost
+    ::close(to_player[1]);
+    ::close(from_player[0]);
+
+    if (pid > 0 && !wait_child(pid, CHILD_EXIT_TIMEOUT)) {
+        ::kill(pid, SIGKILL);
+        ::waitpid(pid, nullptr, 0);
+    }
+
+    return result;
+}
+
+/**
+ * Plays the game with the player in the same process.
+ * The player runs in its own thread and plays through the descriptors of the pipes,
+ * so games may be played in parallel.
+ * If the game is stopped early (e.g. the player is dead), the player reads
+ * the end of file and its writes fail, so it finishes on its own.
+ *
+ * @param world The world of the game
+ * @param buffers Buffers of the game, reused by the following games
+ * @param player Function that plays the whole game, called with the descriptors
+ * of the judge's responses and of the player's commands
+ * @return statistics of the game
+ */
+
+template <typename F> [[nodiscard]] run_result run_in_process(const game_world& world, game_buffers& buffers, F&& player) {
+    std::signal(SIGPIPE, SIG_IGN);
+
+    int to_player[2], from_player[2];
+
+    if (::pipe(to_player) < 0 || ::pipe(from_player) < 0) {
+        std::cerr << "simulator: failed to create pipes" << std::endl;
+        return {};
+    }
+
+    std::thread player_thread([&] {
+        player(to_player[0], from_player[1]);
+
+        ::close(to_player[0]);
+        ::close(from_player[1]);
+    });
+
+    run_result result;
+    interactor(from_player[0], to_player[1], result, buffers).play(world, max_moves(world));
+
+    ::close(to_player[1]);
+    ::close(from_player[0]);
+    player_thread.join();
+
+    return result;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <iostream>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "astar.h"
+#include "backtracking.h"
+#include "simulator.h"
+
+/**
+ * Solvers of this repository by their names, shared by the tools that run them in-process
+ * (simulator, batch, portfolio, replay and the benchmarks), and the loading of the world descriptions
+ */
+
+/** Names of all solvers */
+constexpr std::array<std::string_view, 4> SOLVERS = { "astar", "astar-incremental", "backtracking", "backtracking-goal" };
+
+/** Checks whether the name is the name of any solver */
+[[nodiscard]] inline bool is_solver(const std::string_view name) {
+    return std::ranges::find(SOLVERS, name) != SOLVERS.end();
+}
+
+/**
+ * Adds the solvers from the comma-separated list of names, "all" adds all solvers
+ * @param names The list of names, e.g. astar,backtracking-goal
+ * @param solvers Solvers to add to
+ * @param tool Name of the tool for the error message
+ * @return false if any name is unknown
+ */
+
+[[nodiscard]] inline bool add_solvers(
+        const std::string_view names,
+        std::vector<std::string_view>& solvers,
+        const std::string_view tool
+) {
+    for (std::size_t first = 0; first <= names.size(); ) {
+        const auto last = std::min(names.find(',', first), names.size());
+        const auto name = names.substr(first, last - first);
+        first = last + 1;
+
+        if (name == "all") {
+            solvers.insert(solvers.end(), SOLVERS.begin(), SOLVERS.end());
+            continue;
+        }
+
+        const auto known = std::ranges::find(SOLVERS, name);
+
+        if (known == SOLVERS.end()) {
+            std::cerr << tool << ": unknown solver " << name << std::endl;
+            return false;
+        }
+
+        solvers.push_back(*known);
+    }
+
+    return true;
+}
+
+/**
+ * Plays the whole game with the solver on the square table of the given size
+ * @param solver Name of the solver: astar, astar-incremental, backtracking or backtracking-goal
+ * @param table_size Size of the square table
+ * @param io Transport of the interactive protocol
+ * @param resource Memory resource for all storage of the solve
+ */
+
+template <typename transport> void play_solver(
+        const std::string_view solver,
+        const int table_size,
+        transport& io,
+        std::pmr::memory_resource* resource = std::pmr::get_default_resource()
+) {
+    auto play = [&](const auto& dimensions) {
+        if (solver == "astar")
+            astar::play(dimensions, false, io, resource);
+        else if (solver == "astar-incremental")
+            astar::play(dimensions, true, io, resource);
+        else if (solver == "backtracking-goal")
+            backtracking::play(dimensions, true, io, resource);
+        else
+            backtracking::play(dimensions, false, io, resource);
+    };
+
+    if (table_size == TABLE_SIZE)
+        play(fixed_extent<TABLE_SIZE>());
+    else
+        play(dynamic_extent(table_size, table_size));
+}
+
+/**
+ * Loads the world descriptions (written with simulator --dump) from the stream
+ * @param in The stream with the descriptions
+ * @param name Name of the stream for the error message
+ * @param worlds Worlds to add to
+ * @param tool Name of the tool for the error message
+ * @return false if any description is invalid
+ */
+
+[[nodiscard]] inline bool load_game_worlds(
+        std::istream& in,
+        const std::string_view name,
+        std::vector<game_world>& worlds,
+        const std::string_view tool
+) {
+    for (game_world world; read_game_world(in, world); )
+        worlds.push_back(world);
+
+    if (!in.eof()) {
+        std::cerr << tool << ": invalid world description in " << name << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * Loads the world descriptions from the files, or from stdin if there are no files
+ * @param files Paths of the files
+ * @param worlds Worlds to add to
+ * @param tool Name of the tool for the error messages
+ * @return false if any file fails to open or has an invalid description
+ */
+
+[[nodiscard]] inline bool load_game_worlds(
+        const std::vector<std::string>& files,
+        std::vector<game_world>& worlds,
+        const std::string_view tool
+) {
+    if (files.empty())
+        return load_game_worlds(std::cin, "stdin", worlds, tool);
+
+    for (const auto& path : files) {
+        std::ifstream file(path);
+
+        if (!file) {
+            std::cerr << tool << ": failed to open " << path << std::endl;
+            return false;
+        }
+
+        if (!load_game_worlds(file, path, worlds, tool))
+            return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,196 @@
+/**
+ * Correctness check of the least common ancestor search of the A* solver on long paths.
+ * Trees of parents are built by the breadth-first search over large randomly generated maps,
+ * where walls with a single passage at alternating ends make the paths thousands of cells long.
+ * Both least_common_ancestor() and ancestor_table are compared with the naive walk
+ * (all ancestors of the first cell are marked, then the second cell is lifted until a marked one).
+ * Exits with 1 and prints the first mismatches if any check fails.
+ *
+ * Build: g++ -std=c++20 -O2 -o ancestor_test tests/ancestor_test.cpp
+ */
+
+#include "../astar.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <deque>
+#include <random>
+#include <ranges>
+#include <vector>
+
+/** Size of the square maps */
+constexpr int SIZE = 256;
+
+/** Number of generated maps */
+constexpr int SEEDS = 20;
+
+/** Number of checked pairs of cells on every map */
+constexpr int PAIRS = 2000;
+
+/** Number of reported mismatches */
+constexpr int MAX_REPORTED = 10;
+
+using table_type = astar::game_table<dynamic_extent>;
+
+int failures = 0;
+
+/** Counts the failed check, the first ones are reported */
+void fail(const int seed, const cell_index first, const cell_index second, const char* what,
+        const cell_index expected, const cell_index actual) {
+    if (++failures <= MAX_REPORTED)
+        std::printf("seed %d, cells %zu and %zu: %s, expected %zu, actual %zu\n",
+                seed, static_cast<std::size_t>(first), static_cast<std::size_t>(second), what,
+                static_cast<std::size_t>(expected), static_cast<std::size_t>(actual));
+}
+
+/**
+ * Least common ancestor by the naive walk
+ * @param table The table with the tree of parents
+ * @param first First cell
+ * @param second Second cell
+ * @param is_ancestor Buffer of the marks, all false before and after the call
+ */
+
+[[nodiscard]] cell_index naive_least_common_ancestor(
+        const table_type& table,
+        const cell_index first,
+        const cell_index second,
+        std::vector<bool>& is_ancestor
+) {
+    for (auto c = first; c != NO_CELL; c = table[c].parent)
+        is_ancestor[c] = true;
+
+    auto lca = second;
+
+    while (lca != NO_CELL && !is_ancestor[lca])
+        lca = table[lca].parent;
+
+    for (auto c = first; c != NO_CELL; c = table[c].parent)
+        is_ancestor[c] = false;
+
+    return lca;
+}
+
+/**
+ * Builds the tree of parents by the breadth-first search from (0, 0), closing the cells in order
+ * @param rng Generator of the map and of the order of the neighbours
+ * @param table The table to fill: costs from the player and parents of the reached cells
+ * @param ancestors The binary lifting table, rows are filled as the cells are closed
+ * @return The reached cells
+ */
+
+[[nodiscard]] std::vector<cell_index> build_tree(
+        std::mt19937& rng,
+        table_type& table,
+        astar::ancestor_table<dynamic_extent>& ancestors
+) {
+    std::bernoulli_distribution dangerous(0.15);
+
+    // Every fourth row is a wall with a single passage, at the right and the left end in turn,
+    // the middle row between the walls and both ends are kept safe, so the passages are always connected
+    for (int n = 0; n < SIZE; ++n)
+        for (int m = 0; m < SIZE; ++m) {
+            const bool is_wall = n % 4 == 3 && m != (n % 8 == 3 ? SIZE - 1 : 0);
+            const bool is_passage = n % 4 == 3 || n % 4 == 1 || m == 0 || m == SIZE - 1;
+
+            if (is_wall || (!is_passage && (n + m) > 0 && dangerous(rng)))
+                table[table.index(n, m)].cell_status = 'P';
+        }
+
+    std::vector<cell_index> reached;
+    std::deque<cell_index> queue = { table.index(0, 0) };
+    table[table.index(0, 0)].from_player_cost = 0;
+
+    std::array<std::pair<int, int>, 4> shifts = {{ { 1, 0 }, { -1, 0 }, { 0, 1 }, { 0, -1 } }};
+
+    while (!queue.empty()) {
+        const auto c = queue.front();
+        queue.pop_front();
+
+        ancestors.close(table, c);
+        reached.push_back(c);
+
+        std::ranges::shuffle(shifts, rng);
+
+        for (const auto& [dn, dm] : shifts) {
+            const int n = table.n(c) + dn;
+            const int m = table.m(c) + dm;
+
+            if (n < 0 || n >= SIZE || m < 0 || m >= SIZE)
+                continue;
+
+            auto& neighbour = table[table.index(n, m)];
+
+            if (neighbour.dangerous_status() || neighbour.from_player_cost != INF)
+                continue;
+
+            neighbour.from_player_cost = table[c].from_player_cost + 1;
+            neighbour.parent = c;
+            queue.push_back(table.index(n, m));
+        }
+    }
+
+    return reached;
+}
+
+/**
+ * Compares both searches with the naive walk on the random pairs of the reached cells
+ * @param seed Seed of the map and of the pairs
+ * @return Length of the deepest path of the tree
+ */
+
+int check_map(const int seed) {
+    std::mt19937 rng(seed);
+
+    table_type table(dynamic_extent(SIZE, SIZE));
+    astar::ancestor_table<dynamic_extent> ancestors(table);
+
+    const auto reached = build_tree(rng, table, ancestors);
+
+    std::uniform_int_distribution<std::size_t> pick(0, reached.size() - 1);
+    std::vector<bool> is_ancestor(table.size());
+
+    for (int i = 0; i < PAIRS; ++i) {
+        const auto first = reached[pick(rng)];
+        auto second = reached[pick(rng)];
+
+        // Every fourth pair is the cell and one of its own ancestors
+        if (i % 4 == 0)
+            for (auto lift = pick(rng) % (table[second].from_player_cost + 1); lift > 0; --lift)
+                second = table[second].parent;
+
+        const auto expected = naive_least_common_ancestor(table, first, second, is_ancestor);
+
+        if (const auto actual = astar::least_common_ancestor(table, first, second); actual != expected)
+            fail(seed, first, second, "least_common_ancestor", expected, actual);
+
+        if (const auto actual = ancestors.least_common_ancestor(table, first, second); actual != expected)
+            fail(seed, first, second, "ancestor_table", expected, actual);
+    }
+
+    return std::ranges::max(reached | std::views::transform([&](const cell_index c) {
+        return table[c].from_player_cost;
+    }));
+}
+
+int main() {
+    int max_depth = 0;
+
+    for (int seed = 1; seed <= SEEDS; ++seed)
+        max_depth = std::max(max_depth, check_map(seed));
+
+    // The maps have to produce long paths, otherwise the check is meaningless
+    if (max_depth < SIZE * SIZE / 8) {
+        std::printf("the deepest path is only %d cells long\n", max_depth);
+        return 1;
+    }
+
+    if (failures > 0) {
+        std::printf("%d mismatches\n", failures);
+        return 1;
+    }
+
+    std::printf("ok: %d maps, %d pairs each, deepest path %d cells\n", SEEDS, PAIRS, max_depth);
+    return 0;
+}
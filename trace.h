@@ -0,0 +1,213 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "transport.h"
+
+/**
+ * Binary trace of the recorded session, in the native byte order:
+ * - trace_header
+ * - moves: recorded_move[header.moves]
+ * - offsets of the responses: std::uint32_t[header.moves + 1]
+ * - perceived cells of all responses: perceived_cell[header.cells]
+ * Sections are laid out as the arrays in memory, so the mapped file is viewed without any copying.
+ */
+
+/** @brief Header of the binary trace */
+struct trace_header {
+    std::array<char, 4> magic = TRACE_MAGIC;
+    std::uint32_t version = TRACE_VERSION;
+
+    /** Size of the square table */
+    std::int32_t table_size = 0;
+
+    std::int32_t thanos_variant = 0;
+    std::int32_t inf_stone_x = 0;
+    std::int32_t inf_stone_y = 0;
+
+    /** Reported cost */
+    std::int32_t cost = -1;
+
+    /** Name of the recorded solver (its mode included, e.g. astar-incremental), padded with zeros */
+    std::array<char, 28> solver {};
+
+    std::uint64_t moves = 0;
+    std::uint64_t cells = 0;
+
+    static constexpr std::array<char, 4> TRACE_MAGIC = { 'I', 'S', 'T', 'R' };
+    static constexpr std::uint32_t TRACE_VERSION = 2;
+};
+
+static_assert(sizeof(trace_header) % alignof(recorded_move) == 0);
+
+/**
+ * Writes the recorded session as the binary trace
+ * @param path The file of the trace
+ * @param session The recorded session
+ * @param table_size Size of the square table
+ * @param solver Name of the recorded solver, replayed by default
+ * @return true if the whole trace was written
+ */
+
+inline bool write_trace(
+        const std::string& path,
+        const recorded_session& session,
+        const int table_size,
+        const std::string_view solver
+) {
+    trace_header header;
+    header.table_size = table_size;
+    solver.copy(header.solver.data(), header.solver.size() - 1);
+    header.thanos_variant = session.start.thanos_variant;
+    header.inf_stone_x = session.start.inf_stone_x;
+    header.inf_stone_y = session.start.inf_stone_y;
+    header.cost = session.cost;
+    header.moves = session.moves.size();
+    header.cells = session.cells.size();
+
+    auto* const file = std::fopen(path.c_str(), "wb");
+
+    if (!file)
+        return false;
+
+    auto write_section = [&](const auto& section) {
+        return std::fwrite(section.data(), sizeof(section[0]), section.size(), file) == section.size();
+    };
+
+    const bool is_written = std::fwrite(&header, sizeof(header), 1, file) == 1
+            && write_section(session.moves)
+            && write_section(session.offsets)
+            && write_section(session.cells);
+
+    return std::fclose(file) == 0 && is_written;
+}
+
+/**
+ * @brief Trace file mapped into memory (read-only).
+ * The session is viewed directly in the mapped pages, so loading a trace
+ * costs only the mapping itself, pages are read on the first access.
+ */
+
+class mapped_trace {
+    void* _data = MAP_FAILED;
+    std::size_t _size = 0;
+
+    session_view _session;
+    int _table_size = 0;
+    std::string_view _solver;
+    bool _is_valid = false;
+
+    /**
+     * Checks the header, the sizes of the sections and the offsets of the responses, then views them.
+     * Everything the replay reads is validated once here, so the corrupted trace is rejected
+     * instead of being read out of the mapping
+     */
+
+    void view() {
+        if (_size < sizeof(trace_header))
+            return;
+
+        const auto* const bytes = static_cast<const char*>(_data);
+        const auto& header = *reinterpret_cast<const trace_header*>(bytes);
+
+        if (header.magic != trace_header::TRACE_MAGIC || header.version != trace_header::TRACE_VERSION)
+            return;
+
+        auto is_inside = [&](const int x, const int y) {
+            return x >= 0 && x < header.table_size && y >= 0 && y < header.table_size;
+        };
+
+        if (header.table_size <= 0 || (header.thanos_variant != 1 && header.thanos_variant != 2)
+                || !is_inside(header.inf_stone_x, header.inf_stone_y))
+            return;
+
+        // Counts are compared with the remaining size by division, so corrupted ones can not overflow
+        auto rest = _size - sizeof(trace_header);
+
+        if (header.moves > rest / sizeof(recorded_move))
+            return;
+
+        rest -= header.moves * sizeof(recorded_move);
+
+        if (header.moves + 1 > rest / sizeof(std::uint32_t))
+            return;
+
+        rest -= (header.moves + 1) * sizeof(std::uint32_t);
+
+        if (rest % sizeof(perceived_cell) != 0 || header.cells != rest / sizeof(perceived_cell))
+            return;
+
+        const auto moves_offset = sizeof(trace_header);
+        const auto offsets_offset = moves_offset + header.moves * sizeof(recorded_move);
+        const auto cells_offset = offsets_offset + (header.moves + 1) * sizeof(std::uint32_t);
+
+        const std::span offsets(reinterpret_cast<const std::uint32_t*>(bytes + offsets_offset), header.moves + 1);
+        const std::span cells(reinterpret_cast<const perceived_cell*>(bytes + cells_offset), header.cells);
+
+        // Responses are the consecutive ranges of the cells, from the first cell to the last one
+        if (offsets.front() != 0 || offsets.back() != header.cells || !std::ranges::is_sorted(offsets))
+            return;
+
+        if (!std::ranges::all_of(cells, [&](const perceived_cell& c) { return is_inside(c.x, c.y); }))
+            return;
+
+        _session.start = { header.thanos_variant, header.inf_stone_x, header.inf_stone_y };
+        _session.cost = header.cost;
+        _session.moves = { reinterpret_cast<const recorded_move*>(bytes + moves_offset), header.moves };
+        _session.offsets = offsets;
+        _session.cells = cells;
+        _table_size = header.table_size;
+        _solver = std::string_view(header.solver.data(), header.solver.size());
+        _solver = _solver.substr(0, _solver.find('\0'));
+        _is_valid = true;
+    }
+
+public:
+    explicit mapped_trace(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+
+        if (fd < 0)
+            return;
+
+        struct stat status {};
+
+        if (::fstat(fd, &status) == 0 && status.st_size > 0) {
+            _size = static_cast<std::size_t>(status.st_size);
+            _data = ::mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+
+        ::close(fd);
+
+        if (_data != MAP_FAILED)
+            view();
+    }
+
+    mapped_trace(const mapped_trace&) = delete;
+    mapped_trace& operator=(const mapped_trace&) = delete;
+
+    ~mapped_trace() {
+        if (_data != MAP_FAILED)
+            ::munmap(_data, _size);
+    }
+
+    /** Checks whether the file is mapped and is the valid trace */
+    [[nodiscard]] bool valid() const { return _is_valid; }
+
+    [[nodiscard]] const session_view& session() const { return _session; }
+
+    [[nodiscard]] int table_size() const { return _table_size; }
+
+    /** Name of the recorded solver */
+    [[nodiscard]] std::string_view solver() const { return _solver; }
+};
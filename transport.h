@@ -0,0 +1,361 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "grid.h"
+#include "protocol.h"
+#include "instrumentation.h"
+
+/**
+ * Transport of the interactive protocol. Solvers are templated on it and use:
+ * - game_start start(): the initial input of the game
+ * - void blind_move(int x, int y): the move without the response analysis
+ * - void move(int x, int y): the move whose response may be read with response()
+ * - std::span<const perceived_cell> response(): the response to the last move;
+ *   may be skipped only if the game ends after the move
+ * - void end(int cost): reports the cost of the shortest path or -1
+ * - bool stop_requested() (optional): whether the game is cancelled, e.g. the rival solver
+ *   of the portfolio race has won; solvers check it with stop_requested(io) between their steps
+ *   and give up the search, transports without it are never cancelled
+ *
+ * Backends: stdio_transport for the judge, direct_transport (simulator.h)
+ * that plays with the simulator in-process without any system calls,
+ * and replay_transport that feeds the recorded session.
+ */
+
+/** @brief Initial input of the game */
+struct game_start {
+    /** Thanos perception variant: 1 or 2 */
+    int thanos_variant = 0;
+
+    /** Column of the Infinity Stone */
+    int inf_stone_x = 0;
+
+    /** Row of the Infinity Stone */
+    int inf_stone_y = 0;
+};
+
+/** @brief Perceived cell of the judge's response */
+struct perceived_cell {
+    /** Column of the cell */
+    int x = 0;
+
+    /** Row of the cell */
+    int y = 0;
+
+    char status = 0;
+};
+
+/** Maximum number of perceived cells in the response: the second Thanos perception */
+constexpr std::size_t MAX_RESPONSE_SIZE = std::tuple_size_v<std::remove_cvref_t<decltype(SECOND_PERCEPTION)>>;
+
+/**
+ * Checks whether the game played through the transport is cancelled
+ * @param io Transport of the interactive protocol
+ * @return io.stop_requested() if the transport supports the cancellation, false otherwise
+ */
+
+template <typename transport> [[nodiscard]] bool stop_requested(const transport& io) {
+    if constexpr (requires { { io.stop_requested() } -> std::convertible_to<bool>; })
+        return io.stop_requested();
+    else
+        return false;
+}
+
+/**
+ * @brief Transport over the judge's text protocol: responses are read from the descriptor
+ * with protocol_reader, commands are written with protocol_writer (blind moves are batched)
+ */
+
+class stdio_transport {
+    protocol_reader _reader;
+    protocol_writer _writer;
+
+    std::array<perceived_cell, MAX_RESPONSE_SIZE> _response {};
+    std::size_t _response_size = 0;
+
+public:
+    /**
+     * @param input Descriptor with the judge's responses
+     * @param output Descriptor for the player's commands
+     */
+
+    explicit stdio_transport(const int input = STDIN_FILENO, const int output = STDOUT_FILENO) :
+        _reader(input),
+        _writer(_reader, output) {}
+
+    [[nodiscard]] game_start start() {
+        game_start start;
+        start.thanos_variant = _reader.read_int();
+        start.inf_stone_x = _reader.read_int();
+        start.inf_stone_y = _reader.read_int();
+        instrumentation::game_started();
+        return start;
+    }
+
+    void blind_move(const int x, const int y) {
+        instrumentation::move_sent();
+        _writer.blind_move(x, y);
+    }
+
+    void move(const int x, const int y) {
+        instrumentation::move_sent();
+        _writer.move(x, y);
+    }
+
+    /** Reads the response to the last move, cells over the maximum size of the response are skipped */
+    [[nodiscard]] std::span<const perceived_cell> response() {
+        const int response_size = _reader.read_int();
+        _response_size = 0;
+
+        for (int i = 0; i < response_size; ++i) {
+            perceived_cell cell;
+            cell.x = _reader.read_int();
+            cell.y = _reader.read_int();
+            cell.status = _reader.read_char();
+
+            if (_response_size < _response.size())
+                _response[_response_size++] = cell;
+        }
+
+        instrumentation::response_received();
+        return { _response.data(), _response_size };
+    }
+
+    void end(const int cost) { _writer.end(cost); }
+};
+
+/** @brief Player's move of the recorded session */
+struct recorded_move {
+    /** Column of the cell */
+    int x = 0;
+
+    /** Row of the cell */
+    int y = 0;
+
+    /** Time of sending the move since the start of the session */
+    std::int64_t sent_ns = 0;
+
+    /** Time of reading the response since the start of the session, -1 if the response was not read */
+    std::int64_t received_ns = -1;
+};
+
+/**
+ * @brief Recorded session of the game: the initial input, the player's moves,
+ * the judge's responses and the reported cost. Views the recorded data,
+ * either owned by recorded_session or mapped from the trace file
+ */
+
+struct session_view {
+    game_start start;
+
+    /** Reported cost, -1 if the stone is unreachable */
+    int cost = -1;
+
+    /** Player's moves in the order of sending */
+    std::span<const recorded_move> moves;
+
+    /** Response to the move i is cells[offsets[i], offsets[i + 1]) */
+    std::span<const std::uint32_t> offsets;
+
+    /** Perceived cells of all responses */
+    std::span<const perceived_cell> cells;
+
+    [[nodiscard]] std::span<const perceived_cell> response(const std::size_t move) const {
+        return cells.subspan(offsets[move], offsets[move + 1] - offsets[move]);
+    }
+
+    /**
+     * Time of the player's decisions: from the start or the last response
+     * to every move (including moves that are sent one after another)
+     */
+
+    [[nodiscard]] std::chrono::nanoseconds decision_time() const {
+        std::int64_t total = 0, last_event = 0;
+
+        for (const auto& move : moves) {
+            total += move.sent_ns - last_event;
+            last_event = move.received_ns >= 0 ? move.received_ns : move.sent_ns;
+        }
+
+        return std::chrono::nanoseconds(total);
+    }
+};
+
+/** @brief Session that is recorded by recording_transport */
+struct recorded_session {
+    game_start start;
+    int cost = -1;
+
+    std::vector<recorded_move> moves;
+    std::vector<std::uint32_t> offsets = { 0 };
+    std::vector<perceived_cell> cells;
+
+    [[nodiscard]] session_view view() const { return { start, cost, moves, offsets, cells }; }
+};
+
+/**
+ * @brief Transport that records the session played through another transport, with timestamps.
+ * Responses to the blind moves are read to be recorded, so blind moves are not batched
+ * @tparam transport The transport of the game
+ * @tparam callback Function called with the whole session before the final command is sent
+ * (e.g. to save it while the judge still waits for the player)
+ */
+
+template <typename transport, typename callback> class recording_transport {
+    using clock = std::chrono::steady_clock;
+
+    transport& _transport;
+    recorded_session& _session;
+    callback _on_end;
+    clock::time_point _start = clock::now();
+
+    [[nodiscard]] std::int64_t now() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - _start).count();
+    }
+
+    /** Finishes the response to the previous move, it is empty if it was not read */
+    void close_response() {
+        if (_session.offsets.size() == _session.moves.size())
+            _session.offsets.push_back(static_cast<std::uint32_t>(_session.cells.size()));
+    }
+
+public:
+    /**
+     * @param inner The transport of the game
+     * @param session The session to record, it has to be empty
+     * @param on_end Function called with the whole session before the final command is sent
+     */
+
+    recording_transport(transport& inner, recorded_session& session, callback on_end) :
+        _transport(inner),
+        _session(session),
+        _on_end(std::move(on_end)) {}
+
+    [[nodiscard]] game_start start() {
+        _session.start = _transport.start();
+        _start = clock::now();
+        return _session.start;
+    }
+
+    void blind_move(const int x, const int y) {
+        move(x, y);
+        [[maybe_unused]] const auto skipped = response();
+    }
+
+    void move(const int x, const int y) {
+        close_response();
+        _session.moves.push_back({ x, y, now() });
+        _transport.move(x, y);
+    }
+
+    [[nodiscard]] std::span<const perceived_cell> response() {
+        const auto cells = _transport.response();
+        _session.moves.back().received_ns = now();
+        _session.cells.insert(_session.cells.end(), cells.begin(), cells.end());
+        close_response();
+        return cells;
+    }
+
+    void end(const int cost) {
+        close_response();
+        _session.cost = cost;
+        _on_end(static_cast<const recorded_session&>(_session));
+        _transport.end(cost);
+    }
+};
+
+/**
+ * @brief Transport that feeds the recorded session to the player.
+ * Moves are compared with the recorded ones; after the first different move
+ * the world is unknown, so all following responses are empty.
+ * Time of the player's decisions is measured the same way as in the recorded session
+ */
+
+class replay_transport {
+    using clock = std::chrono::steady_clock;
+
+    session_view _session;
+
+    /** Index of the next move */
+    std::size_t _next_move = 0;
+
+    /** Index of the first move that differs from the recorded one */
+    std::size_t _divergence = SIZE_MAX;
+
+    std::span<const perceived_cell> _response;
+    int _reported = -1;
+    bool _is_finished = false;
+
+    clock::time_point _last_event = clock::now();
+    std::chrono::nanoseconds _decision_time {};
+
+public:
+    explicit replay_transport(const session_view session) : _session(session) {}
+
+    [[nodiscard]] game_start start() {
+        _last_event = clock::now();
+        return _session.start;
+    }
+
+    void blind_move(const int x, const int y) { move(x, y); }
+
+    void move(const int x, const int y) {
+        const auto sent = clock::now();
+        _decision_time += sent - _last_event;
+        _last_event = sent;
+
+        const auto index = _next_move++;
+        _response = {};
+
+        if (_divergence == SIZE_MAX && (index >= _session.moves.size()
+                || _session.moves[index].x != x || _session.moves[index].y != y))
+            _divergence = index;
+
+        if (_divergence == SIZE_MAX)
+            _response = _session.response(index);
+    }
+
+    [[nodiscard]] std::span<const perceived_cell> response() {
+        _last_event = clock::now();
+        return _response;
+    }
+
+    void end(const int cost) {
+        _reported = cost;
+        _is_finished = true;
+    }
+
+    /** Checks whether the player made the same moves and reported the same cost */
+    [[nodiscard]] bool matches() const {
+        return _divergence == SIZE_MAX && _next_move == _session.moves.size()
+                && _is_finished && _reported == _session.cost;
+    }
+
+    /**
+     * Index of the first move that differs from the recorded one: the first missing move if the player
+     * finished earlier, the number of moves if only the cost differs, SIZE_MAX if the session matches
+     */
+
+    [[nodiscard]] std::size_t divergence() const {
+        if (_divergence != SIZE_MAX || matches())
+            return _divergence;
+
+        return std::min(_next_move, _session.moves.size());
+    }
+
+    [[nodiscard]] int reported() const { return _reported; }
+
+    /** Time of the player's decisions during the replay */
+    [[nodiscard]] std::chrono::nanoseconds decision_time() const { return _decision_time; }
+};